@@ -1,12 +1,38 @@
 #ifdef _WIN32
+#include <winsock2.h>   // must come before windows.h (frame streaming)
 #include <windows.h>    // must be included before GL headers on Windows
+#else
+#include <sys/socket.h> // frame streaming
+#include <sys/select.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#include <csignal>
+#include <fcntl.h>      // scene cache mapping
+#include <sys/mman.h>
+#include <sys/stat.h>
+typedef int SOCKET;
+#define INVALID_SOCKET (-1)
+#define closesocket close
+#define SD_BOTH SHUT_RDWR
 #endif
 
 #include <GL/glut.h>
-#include <cstdlib> // for rand, srand
+#include <cstdlib> // for atof, exit
 #include <cmath>    // sin, cos, sqrt
 #include <cstring>
+#include <cerrno>       // strerror(errno) for file errors
 #include <cstdio>       // for sprintf
+#include <cstdarg>      // timeline log messages
+#include <chrono>       // steady_clock for frame timing
+#include <algorithm>    // sort (benchmark statistics)
+#include <thread>       // thumbnail workers
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <memory>       // shared_ptr (streamed frames)
+#include <vector>
 
 
 const float PI = 3.14159265358979323846f;
@@ -22,6 +48,46 @@ float camDist   = 35.0f;   // distance from center
 
 bool  isPaused = false;
 
+// ----------------- Quality levels (adaptive governor) -----------------
+struct QualityLevel {
+    const char* name;
+    int maxNucleonsDraw;     // cap on nucleon spheres in the nucleus
+    int nucleonSlices;       // slices & stacks for nucleon spheres
+    int electronSlices;      // slices & stacks for electron spheres
+    int orbitSegments;       // line segments per orbit ring
+    int timerMs;             // animation timer interval
+};
+
+// Ordered cheapest -> most expensive; "High" matches the original fixed values
+QualityLevel qualityLevels[] = {
+    //  name       nucleons nSlices eSlices orbitSeg timerMs
+    { "Minimal",      16,      6,      8,      24,     33 },
+    { "Low",          30,      8,     10,      40,     33 },
+    { "Medium",       45,     12,     14,      64,     16 },
+    { "High",         60,     16,     20,     100,     16 },
+    { "Ultra",       120,     20,     24,     160,     16 },
+};
+const int numQualityLevels = sizeof(qualityLevels) / sizeof(qualityLevels[0]);
+int qualityIndex = 3;        // start at "High"
+
+float frameBudgetMs    = 16.6f;  // target render time per frame (--budget)
+bool  governorEnabled  = true;   // 'Q' toggles auto / manual
+float avgFrameMs       = 0.0f;   // smoothed render time of display()
+int   overBudgetFrames  = 0;
+int   underBudgetFrames = 0;
+
+// Hysteresis: drop fast when over budget, climb slowly when well under it
+const float GOV_SMOOTHING     = 0.1f;   // EMA weight of the newest frame
+const float GOV_DOWN_RATIO    = 1.0f;   // avg > budget          -> too slow
+const float GOV_UP_RATIO      = 0.5f;   // avg < budget * ratio  -> headroom
+const int   GOV_DOWN_FRAMES   = 20;     // consecutive frames before stepping down
+const int   GOV_UP_FRAMES     = 120;    // consecutive frames before stepping up
+const int   GOV_STABLE_FRAMES = 1800;   // ~30 s at one level clears the backoff
+int   framesSinceQualityChange = 0;
+bool  lastQualityChangeUp      = false;
+int   upgradeBackoff           = 1;     // doubles when an upgrade gets undone quickly
+bool  governorInAtom           = false; // last measured frame was an atom frame
+
 // ----------------- Element data -----------------
 struct ElementInfo {
     int  Z;                  // atomic number
@@ -173,6 +239,173 @@ ElementInfo elements[] = {
 const int numElements = sizeof(elements) / sizeof(elements[0]);
 int selectedIndex = 0;
 
+// ----------------- Element properties (detail view, heatmaps) -----------------
+struct ElementProps {
+    int   Z;
+    float mass;                // standard atomic weight; whole number = most stable isotope
+    float electronegativity;   // Pauling, 0 = unknown
+    float radius;              // empirical atomic radius in pm, 0 = unknown
+    float density;             // g/cm^3 (gases at STP), 0 = unknown
+};
+
+ElementProps elementProps[] = {
+    //   Z      mass     EN   radius      density
+    {   1,    1.008f,  2.20f,   25.0f,  0.00008988f },   // H
+    {   2,   4.0026f,   0.0f,    0.0f,   0.0001785f },   // He
+    {   3,     6.94f,  0.98f,  145.0f,       0.534f },   // Li
+    {   4,   9.0122f,  1.57f,  105.0f,        1.85f },   // Be
+    {   5,    10.81f,  2.04f,   85.0f,        2.34f },   // B
+    {   6,   12.011f,  2.55f,   70.0f,       2.267f },   // C
+    {   7,   14.007f,  3.04f,   65.0f,   0.0012506f },   // N
+    {   8,   15.999f,  3.44f,   60.0f,    0.001429f },   // O
+    {   9,   18.998f,  3.98f,   50.0f,    0.001696f },   // F
+    {  10,   20.180f,   0.0f,    0.0f,   0.0009002f },   // Ne
+    {  11,   22.990f,  0.93f,  180.0f,       0.968f },   // Na
+    {  12,   24.305f,  1.31f,  150.0f,       1.738f },   // Mg
+    {  13,   26.982f,  1.61f,  125.0f,        2.70f },   // Al
+    {  14,   28.085f,  1.90f,  110.0f,      2.3296f },   // Si
+    {  15,   30.974f,  2.19f,  100.0f,        1.82f },   // P
+    {  16,    32.06f,  2.58f,  100.0f,       2.067f },   // S
+    {  17,    35.45f,  3.16f,  100.0f,    0.003214f },   // Cl
+    {  18,   39.948f,   0.0f,    0.0f,   0.0017837f },   // Ar
+    {  19,   39.098f,  0.82f,  220.0f,        0.89f },   // K
+    {  20,   40.078f,  1.00f,  180.0f,        1.55f },   // Ca
+    {  21,   44.956f,  1.36f,  160.0f,       2.985f },   // Sc
+    {  22,   47.867f,  1.54f,  140.0f,       4.506f },   // Ti
+    {  23,   50.942f,  1.63f,  135.0f,         6.0f },   // V
+    {  24,   51.996f,  1.66f,  140.0f,        7.19f },   // Cr
+    {  25,   54.938f,  1.55f,  140.0f,        7.21f },   // Mn
+    {  26,   55.845f,  1.83f,  140.0f,       7.874f },   // Fe
+    {  27,   58.933f,  1.88f,  135.0f,        8.90f },   // Co
+    {  28,   58.693f,  1.91f,  135.0f,       8.908f },   // Ni
+    {  29,   63.546f,  1.90f,  135.0f,        8.96f },   // Cu
+    {  30,    65.38f,  1.65f,  135.0f,        7.14f },   // Zn
+    {  31,   69.723f,  1.81f,  130.0f,        5.91f },   // Ga
+    {  32,   72.630f,  2.01f,  125.0f,       5.323f },   // Ge
+    {  33,   74.922f,  2.18f,  115.0f,       5.727f },   // As
+    {  34,   78.971f,  2.55f,  115.0f,        4.81f },   // Se
+    {  35,   79.904f,  2.96f,  115.0f,      3.1028f },   // Br
+    {  36,   83.798f,  3.00f,    0.0f,    0.003749f },   // Kr
+    {  37,   85.468f,  0.82f,  235.0f,       1.532f },   // Rb
+    {  38,    87.62f,  0.95f,  200.0f,        2.64f },   // Sr
+    {  39,   88.906f,  1.22f,  180.0f,       4.472f },   // Y
+    {  40,   91.224f,  1.33f,  155.0f,        6.52f },   // Zr
+    {  41,   92.906f,   1.6f,  145.0f,        8.57f },   // Nb
+    {  42,    95.95f,  2.16f,  145.0f,       10.28f },   // Mo
+    {  43,     98.0f,   1.9f,  135.0f,        11.0f },   // Tc
+    {  44,   101.07f,   2.2f,  130.0f,       12.45f },   // Ru
+    {  45,   102.91f,  2.28f,  135.0f,       12.41f },   // Rh
+    {  46,   106.42f,  2.20f,  140.0f,      12.023f },   // Pd
+    {  47,   107.87f,  1.93f,  160.0f,       10.49f },   // Ag
+    {  48,   112.41f,  1.69f,  155.0f,        8.65f },   // Cd
+    {  49,   114.82f,  1.78f,  155.0f,        7.31f },   // In
+    {  50,   118.71f,  1.96f,  145.0f,       7.287f },   // Sn
+    {  51,   121.76f,  2.05f,  145.0f,       6.685f },   // Sb
+    {  52,   127.60f,   2.1f,  140.0f,       6.232f },   // Te
+    {  53,   126.90f,  2.66f,  140.0f,        4.93f },   // I
+    {  54,   131.29f,  2.60f,    0.0f,    0.005894f },   // Xe
+    {  55,   132.91f,  0.79f,  260.0f,        1.93f },   // Cs
+    {  56,   137.33f,  0.89f,  215.0f,        3.51f },   // Ba
+    {  57,   138.91f,  1.10f,  195.0f,       6.162f },   // La
+    {  58,   140.12f,  1.12f,  185.0f,        6.77f },   // Ce
+    {  59,   140.91f,  1.13f,  185.0f,        6.77f },   // Pr
+    {  60,   144.24f,  1.14f,  185.0f,        7.01f },   // Nd
+    {  61,    145.0f,  1.13f,  185.0f,        7.26f },   // Pm
+    {  62,   150.36f,  1.17f,  185.0f,        7.52f },   // Sm
+    {  63,   151.96f,   1.2f,  185.0f,       5.244f },   // Eu
+    {  64,   157.25f,   1.2f,  180.0f,        7.90f },   // Gd
+    {  65,   158.93f,   1.1f,  175.0f,        8.23f },   // Tb
+    {  66,   162.50f,  1.22f,  175.0f,        8.54f },   // Dy
+    {  67,   164.93f,  1.23f,  175.0f,        8.79f },   // Ho
+    {  68,   167.26f,  1.24f,  175.0f,       9.066f },   // Er
+    {  69,   168.93f,  1.25f,  175.0f,        9.32f },   // Tm
+    {  70,   173.05f,   1.1f,  175.0f,        6.90f },   // Yb
+    {  71,   174.97f,  1.27f,  175.0f,       9.841f },   // Lu
+    {  72,   178.49f,   1.3f,  155.0f,       13.31f },   // Hf
+    {  73,   180.95f,   1.5f,  145.0f,       16.69f },   // Ta
+    {  74,   183.84f,  2.36f,  135.0f,       19.25f },   // W
+    {  75,   186.21f,   1.9f,  135.0f,       21.02f },   // Re
+    {  76,   190.23f,   2.2f,  130.0f,       22.59f },   // Os
+    {  77,   192.22f,  2.20f,  135.0f,       22.56f },   // Ir
+    {  78,   195.08f,  2.28f,  135.0f,       21.45f },   // Pt
+    {  79,   196.97f,  2.54f,  135.0f,        19.3f },   // Au
+    {  80,   200.59f,  2.00f,  150.0f,      13.534f },   // Hg
+    {  81,   204.38f,  1.62f,  190.0f,       11.85f },   // Tl
+    {  82,    207.2f,  2.33f,  180.0f,       11.34f },   // Pb
+    {  83,   208.98f,  2.02f,  160.0f,        9.78f },   // Bi
+    {  84,    209.0f,   2.0f,  190.0f,       9.196f },   // Po
+    {  85,    210.0f,   2.2f,    0.0f,         0.0f },   // At
+    {  86,    222.0f,   2.2f,    0.0f,     0.00973f },   // Rn
+    {  87,    223.0f,  0.79f,    0.0f,         0.0f },   // Fr
+    {  88,    226.0f,   0.9f,  215.0f,         5.5f },   // Ra
+    {  89,    227.0f,   1.1f,  195.0f,       10.07f },   // Ac
+    {  90,   232.04f,   1.3f,  180.0f,       11.72f },   // Th
+    {  91,   231.04f,   1.5f,  180.0f,       15.37f },   // Pa
+    {  92,   238.03f,  1.38f,  175.0f,       18.95f },   // U
+    {  93,    237.0f,  1.36f,  175.0f,       20.45f },   // Np
+    {  94,    244.0f,  1.28f,  175.0f,       19.84f },   // Pu
+    {  95,    243.0f,  1.13f,  175.0f,       13.69f },   // Am
+    {  96,    247.0f,  1.28f,    0.0f,       13.51f },   // Cm
+    {  97,    247.0f,   1.3f,    0.0f,       14.79f },   // Bk
+    {  98,    251.0f,   1.3f,    0.0f,        15.1f },   // Cf
+    {  99,    252.0f,   1.3f,    0.0f,        8.84f },   // Es
+    { 100,    257.0f,   1.3f,    0.0f,         0.0f },   // Fm
+    { 101,    258.0f,   1.3f,    0.0f,         0.0f },   // Md
+    { 102,    259.0f,   1.3f,    0.0f,         0.0f },   // No
+    { 103,    266.0f,   1.3f,    0.0f,         0.0f },   // Lr
+    { 104,    267.0f,   0.0f,    0.0f,         0.0f },   // Rf
+    { 105,    268.0f,   0.0f,    0.0f,         0.0f },   // Db
+    { 106,    269.0f,   0.0f,    0.0f,         0.0f },   // Sg
+    { 107,    270.0f,   0.0f,    0.0f,         0.0f },   // Bh
+    { 108,    269.0f,   0.0f,    0.0f,         0.0f },   // Hs
+    { 109,    278.0f,   0.0f,    0.0f,         0.0f },   // Mt
+    { 110,    281.0f,   0.0f,    0.0f,         0.0f },   // Ds
+    { 111,    282.0f,   0.0f,    0.0f,         0.0f },   // Rg
+    { 112,    285.0f,   0.0f,    0.0f,         0.0f },   // Cn
+    { 113,    286.0f,   0.0f,    0.0f,         0.0f },   // Nh
+    { 114,    289.0f,   0.0f,    0.0f,         0.0f },   // Fl
+    { 115,    290.0f,   0.0f,    0.0f,         0.0f },   // Mc
+    { 116,    293.0f,   0.0f,    0.0f,         0.0f },   // Lv
+    { 117,    294.0f,   0.0f,    0.0f,         0.0f },   // Ts
+    { 118,    294.0f,   0.0f,    0.0f,         0.0f },   // Og
+};
+
+char elementConfig[numElements][48];   // ground-state configuration, built once
+
+// ----------------- Table view (zoom / pan / colouring) -----------------
+struct TableView {
+    float cx, cy;     // centre in table space (0..100)
+    float zoom;       // 1 = whole table
+};
+
+TableView tableView       = { 50.0f, 50.0f, 1.0f };   // what is drawn this frame
+TableView tableViewTarget = { 50.0f, 50.0f, 1.0f };   // where it is easing to
+const float TABLE_MAX_ZOOM = 16.0f;
+
+bool tablePanning = false;             // right-drag
+int  panLastX = 0, panLastY = 0;
+
+// Cell pixel widths where more detail appears
+const float LOD_NAME_PX   = 70.0f;     // + name, atomic number
+const float LOD_DETAIL_PX = 130.0f;    // + mass, configuration
+const float LOD_CHARTS_PX = 240.0f;    // + property bars
+
+enum ColorMode { COLOR_CATEGORY, COLOR_ELECTRONEGATIVITY, COLOR_RADIUS, COLOR_DENSITY,
+                 COLOR_MASS, NUM_COLOR_MODES };
+const char* colorModeNames[NUM_COLOR_MODES] = {
+    "Block", "Electronegativity (Pauling)", "Atomic radius (pm)", "Density (g/cm3, log)",
+    "Atomic mass (u)"
+};
+
+// Per-property colour buffers, filled once by buildPropertyColors()
+float propertyNorm[NUM_COLOR_MODES][numElements];      // 0..1, -1 = unknown
+float propertyColors[NUM_COLOR_MODES][numElements][3];
+float propertyMin[NUM_COLOR_MODES], propertyMax[NUM_COLOR_MODES];
+
+ColorMode colorMode = COLOR_CATEGORY;
+float colorFrom[numElements][3];       // colours at the start of a transition
+float colorBlend = 1.0f;               // 0 -> 1 over the transition
+
 // ----------------- 2D table cell data -----------------
 struct CellRect {
     float x, y, w, h;   // position in 2D (0..100)
@@ -181,6 +414,14 @@ struct CellRect {
 CellRect cellRects[200];
 int cellCount = 0;
 
+// Table layout in table space (0..100)
+const float TABLE_START_X = 5.0f;
+const float TABLE_CELL_W  = 3.5f;
+const float TABLE_ROW_H   = 6.5f;
+const float TABLE_TOP_Y   = 88.0f;   // period 1
+const float TABLE_LANTH_Y = 25.0f;
+const float TABLE_ACT_Y   = 18.0f;
+
 // ----------------- Electrons for 3D atom -----------------
 struct Electron {
     float radius;      // orbit radius
@@ -191,18 +432,270 @@ struct Electron {
 };
 
 const int MAX_ELECTRONS = 120;  // up to Z=118
+const int NUM_SHELLS    = 7;
+
+// Simple Bohr-style capacities, total 118. Shell s owns the fixed slot range
+// electrons[shellFirst[s] .. shellFirst[s] + shellCapacity[s]) and keeps its
+// electrons packed at the front, so a ground state is one contiguous prefix
+const int shellCapacity[NUM_SHELLS] = { 2, 8, 18, 32, 32, 18, 8 };
+const int shellFirst[NUM_SHELLS]    = { 0, 2, 10, 28, 60, 92, 110 };
+const int SHELL_SLOTS = 118;            // sum of shellCapacity
+
+const float SHELL_BASE_RADIUS = 6.0f;   // innermost shell radius
+const float SHELL_RADIUS_STEP = 3.0f;   // distance between shells
+const float SHELL_BASE_SPEED  = 1.5f;   // base angular speed
+
 Electron electrons[MAX_ELECTRONS];
-int numElectrons = 0;
+int numElectrons = 0;                   // bound electrons, all shells
+int shellCount[NUM_SHELLS];             // electrons in each shell
+bool shellDirty[NUM_SHELLS];            // membership changed: rebalance spacing
+bool shellAnimating[NUM_SHELLS];        // has electrons still settling
+
+// Ions and excited states
+struct ElectronTween {
+    float t;                      // 0 -> 1 flight from the values below into the slot
+    float radius, tiltX, tiltY;   // where the electron came from
+    float slide;                  // degrees still to cover after a rebalance
+};
+
+struct EscapingElectron {
+    Electron e;                   // keeps orbiting while it flies off
+    float    t;                   // 0 -> 1, then gone
+};
+
+const int   MAX_ANION_CHARGE   = 4;      // extra electrons beyond Z, if the shells have room
+const int   MAX_ESCAPING       = 16;
+const float ELECTRON_FLIGHT_S  = 0.7f;   // capture / excitation / escape time
+
+ElectronTween    electronTweens[MAX_ELECTRONS];
+EscapingElectron escaping[MAX_ESCAPING];
+int              numEscaping = 0;
+int              ionCharge   = 0;        // Z - numElectrons
+
+GLuint orbitLists = 0;                  // one display list per shell ring
+int    orbitListSegments[NUM_SHELLS];   // segments compiled in; 0 = stale
+
+// ----------------- Nucleus layout -----------------
+struct Nucleon {
+    float x, y, z;     // position inside the cluster
+    bool  proton;      // false = neutron
+};
+
+const int MAX_NUCLEONS = 160;   // >= largest maxNucleonsDraw
+
+const float NUCLEUS_BASE_RADIUS  = 3.0f;    // cluster radius = base + perZ * Z
+const float NUCLEUS_RADIUS_PER_Z = 0.01f;
+const unsigned int LAYOUT_LCG_MUL = 1664525u;
+const unsigned int LAYOUT_LCG_ADD = 1013904223u;
+
+Nucleon nucleons[MAX_NUCLEONS];
+
+// ----------------- Scene cache (memory-mapped prebuilt data) -----------------
+struct SphereMesh {
+    int slices;
+    int vertexCount;
+    int indexCount;
+    const float*          vertices;   // unit sphere xyz, doubles as normals
+    const unsigned short* indices;    // GL_TRIANGLES
+};
+
+const int   MAX_SPHERE_MESHES = 16;
+const char* SCENE_CACHE_FILE  = "atom_scene.cache";
+
+SphereMesh sphereMeshes[MAX_SPHERE_MESHES];
+int        numSphereMeshes = 0;
+
+// Views into the mapped file (or sceneBuilt after a rebuild); 0 until loaded
+const int*      sceneShellIndex       = 0;
+const Electron* sceneShells           = 0;
+const float*    sceneNucleusPositions = 0;
+
+const unsigned char* sceneMapped = 0;
+size_t               sceneMappedSize = 0;
+std::vector<unsigned char> sceneBuilt;
+const char* sceneCacheStatus = "none";       // hit / rebuilt / disabled
+bool        useSceneCache    = true;         // --no-scene-cache
+
+double appStartMs = 0.0;                     // for time-to-first-frame
+bool   firstFrameDone = false;
+
+// ----------------- Atom thumbnails (table cells) -----------------
+const int THUMB_SIZE        = 32;           // pixels per side
+const int THUMB_ATLAS_COLS  = 16;           // 16 x 8 tiles >= 118 elements
+const int THUMB_ATLAS_ROWS  = 8;
+const int THUMB_NUCLEONS    = 60;           // fixed cap, independent of quality level
+const int THUMB_UPLOADS_PER_FRAME = 8;
+const int MAX_THUMB_WORKERS = 4;
+const char* THUMB_CACHE_FILE = "atom_thumbs.cache";
+
+enum ThumbState { THUMB_PENDING, THUMB_RUNNING, THUMB_READY };
+
+unsigned char thumbPixels[numElements][THUMB_SIZE * THUMB_SIZE * 4];   // RGBA
+ThumbState    thumbState[numElements];
+int           thumbReadyQueue[numElements];   // finished, waiting for upload
+int           thumbReadyCount = 0;
+int           thumbsRendered  = 0;            // by workers (not from disk)
+bool          thumbInAtlas[numElements];      // GL thread only
+
+std::mutex              thumbMutex;           // guards everything above + focus
+std::condition_variable thumbWake;
+std::thread             thumbWorkers[MAX_THUMB_WORKERS];
+int                     numThumbWorkers = 0;
+bool                    thumbStop = false;
+
+float  thumbFocusX = -1.0f;                   // cursor in table space, -1 = unknown
+float  thumbFocusY = -1.0f;
+int    thumbSelected = 0;                     // copy of selectedIndex for the workers
+GLuint thumbAtlasTex = 0;
+
+// ----------------- Frame streaming (MJPEG over HTTP) -----------------
+const int MAX_STREAM_VIEWERS = 64;
+const int MAX_STREAM_CLIENTS = MAX_STREAM_VIEWERS + 16;   // viewers + short requests
+const int STREAM_REQUEST_TIMEOUT_MS = 5000;   // to receive a full request head
+
+bool   streamEnabled = false;                 // --stream [port]
+bool   streamPublic  = false;                 // --stream-public: all interfaces, not loopback
+int    streamPort    = 8090;
+int    streamFps     = 30;                    // --stream-fps, capture rate cap
+int    streamQuality = 75;                    // JPEG quality 1..100
+double streamLastCaptureMs = 0.0;
+std::vector<unsigned char> streamCapture;     // GL thread readback target
+
+std::mutex              streamMutex;          // guards everything below
+std::condition_variable streamRawReady;       // GL thread -> encoder
+std::condition_variable streamNewFrame;       // encoder -> viewers
+std::vector<unsigned char> streamRaw;         // frame waiting for the encoder
+int    streamRawWidth = 0, streamRawHeight = 0;
+bool   streamRawPending = false;
+std::shared_ptr<const std::vector<unsigned char> > streamLatest;   // newest JPEG, shared by all viewers
+unsigned long streamSeq = 0;
+int    streamViewers = 0;                     // clients on /stream.mjpg
+int    streamSnapshotWaiters = 0;             // /frame.jpg requests waiting for a capture
+std::atomic<bool> streamStop(false);
+
+struct StreamClient {
+    std::thread thread;                       // joined by the server / on shutdown
+    SOCKET      socket;
+    bool        active;                       // socket open, thread running
+};
+StreamClient streamClients[MAX_STREAM_CLIENTS];
+
+SOCKET      streamListenSocket = INVALID_SOCKET;
+std::thread streamServerThread;
+std::thread streamEncoderThread;
+
+// ----------------- Scripted timeline (camera paths, kiosk) -----------------
+struct CameraKey {
+    float t;           // seconds on the simulation clock
+    float v[3];        // camAngleX, camAngleY, camDist
+};
+
+enum TimelineOp { TL_ELEMENT, TL_MODE, TL_COLOR, TL_ZOOM, TL_ION, TL_EXCITE, TL_GROUND };
+
+struct TimelineEvent {
+    float t;
+    int   op;          // TimelineOp
+    int   arg;         // element index, Mode, ColorMode, charge, count, or -1 (zoom off)
+};
+
+const int MAX_CAMERA_KEYS     = 256;
+const int MAX_TIMELINE_EVENTS = 256;
+
+// Filled once by loadTimeline(); playback only moves the cursors
+CameraKey     cameraKeys[MAX_CAMERA_KEYS];
+int           numCameraKeys = 0;
+TimelineEvent timelineEvents[MAX_TIMELINE_EVENTS];
+int           numTimelineEvents = 0;
+float         timelineLength = 0.0f;   // 'loop' time, else the last key/event
+bool          timelineLoop   = false;
+
+double timelineClock   = 0.0;          // advanced by timer ticks, not wall time
+int    timelineCursor  = 0;            // next event to fire
+int    cameraCursor    = 0;            // current spline segment
+bool   timelinePlaying = false;
+bool   kioskMode       = false;        // --kiosk: loop, fullscreen, ignore input
+FILE*  timelineLog     = stdout;       // stderr / 0 while benchmarking
 
 // Global rotation for whole atom
 float globalRotation = 0.0f;
 
 // ----------------- Function declarations -----------------
 void init();
+void cameraEye(float* eye);
 void setCamera3D();
 void setupElectronsFromElement(const ElementInfo& e);
+int  buildElectronShells(const ElementInfo& e, Electron* out);
+int  fillGroundShells(int count, Electron* out);
+void groundShellCounts(int count, int* counts);
+void resetShellState(int count);
+void shellSlotElectron(int shell, int i, int inShell, Electron& el);
+
+double nowMs();
+void setQualityLevel(int index, const char* reason);
+void updateQualityGovernor(float frameMs);
+int  animationTimerMs();
+void formatQualityStatus(char* buf);
+
+void updateElectrons(Electron* list, int count, float stepScale);
+void advanceOrbits(float stepScale);
+void electronVisual(int slot, Electron& v);
+int  addElectron(int shell, const Electron* from);
+bool removeElectron(int shell, Electron& visual);
+void rebalanceShell(int shell);
+void updateElectronShells(float dt);
+bool ionizeElectron();
+bool captureElectron();
+int  maxAnionCharge(int Z);
+bool exciteElectron();
+int  relaxElectrons();
+void setIonCharge(int charge);
+void changeAtomElement(int elementIndex);
+void formatIonStatus(char* buf);
+int  neutronCount(int Z);
+float layoutRandom(unsigned int& state);
+int  nucleonSplit(int Z, int maxNucleons, int& drawProtons);
+int  buildNucleusLayout(const ElementInfo& e, int maxNucleons, Nucleon* out);
+int  prepareNucleus(const ElementInfo& e, int maxNucleons);
+void layoutPeriodicTable();
+int  hitTestTable(float fx, float fy);
+int  rasterLineDDA(float x1, float y1, float x2, float y2, void (*plot)(float, float));
+
+unsigned int thumbSettingsKey();
+void renderAtomThumbnail(const ElementInfo& e, unsigned char* rgba);
+bool loadThumbnailCache();
+void saveThumbnailCache();
+void thumbWorkerLoop();
+void startThumbnailJobs();
+void stopThumbnailJobs();
+void setThumbnailFocus(float fx, float fy);
+void uploadReadyThumbnails();
+
+void encodeJPEG(const unsigned char* rgb, int width, int height, int quality,
+                std::vector<unsigned char>& out);
+bool startFrameStreaming(int port);
+void stopFrameStreaming();
+void captureStreamFrame(int w, int h);
+void formatStreamStatus(char* buf);
+
+void buildSceneImage(std::vector<unsigned char>& image);
+bool bindSceneImage(const unsigned char* image, size_t size);
+void unbindSceneImage();
+void loadSceneCache(bool useFile);
+void drawSphere(float radius, int slices);
 
 void drawText2D(float x, float y, const char* text, void* font);
+void buildElementConfigs();
+void buildPropertyColors();
+void setColorMode(int mode);
+void tableViewRect(const TableView& v, float& left, float& bottom, float& width, float& height);
+void windowToTable(int x, int y, float& fx, float& fy);
+void zoomTableAt(float fx, float fy, float factor);
+void zoomToCell(int elementIndex);
+void clampTableView(TableView& v);
+void updateTableView(float dt);
+int  cullTableCells(int winW, int winH, int* visible, float* rects, int& lod);
+void drawCellThumbnails(const float* rects, const int* cells, int count, int lod);
+float detailThumbSide(const float* r);
 void drawPeriodicTable();
 void drawNucleus(const ElementInfo& e);
 void drawOrbit(const Electron &e);
@@ -215,6 +708,17 @@ void timer(int value);
 void keyboard(unsigned char key, int x, int y);
 void specialKeys(int key, int x, int y);
 void mouse(int button, int state, int x, int y);
+void passiveMotion(int x, int y);
+void motion(int x, int y);
+
+bool loadTimeline(const char* path);
+void rewindTimeline();
+void advanceTimeline(float dt);
+void evaluateCameraPath(double t, float* out);
+void applyTimelineEvent(const TimelineEvent& ev);
+bool timelineBlocksInput();
+
+int  runBenchmarks(const char* outPath, const char** scenarios, int numScenarios);
 
 // --------------------------------------------------------
 // Initialization
@@ -222,6 +726,7 @@ void mouse(int button, int state, int x, int y);
 void init() {
     glEnable(GL_DEPTH_TEST);
     glEnable(GL_COLOR_MATERIAL);
+    glEnable(GL_NORMALIZE);    // cached unit spheres are scaled by the modelview
 
     // Lighting for 3D mode
     glEnable(GL_LIGHTING);
@@ -235,7 +740,39 @@ void init() {
 
     glClearColor(0.02f, 0.02f, 0.08f, 1.0f); // dark background
 
+    // Table geometry, shells, nucleus layouts and sphere meshes
+    double cacheStart = nowMs();
+    loadSceneCache(useSceneCache);
+    printf("[startup] scene cache %s in %.2f ms\n", sceneCacheStatus, nowMs() - cacheStart);
+    fflush(stdout);
+
     setupElectronsFromElement(elements[selectedIndex]);
+    buildElementConfigs();
+    buildPropertyColors();
+
+    // Empty atlas; tiles arrive from the cache or the workers
+    glGenTextures(1, &thumbAtlasTex);
+    glBindTexture(GL_TEXTURE_2D, thumbAtlasTex);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA,
+                 THUMB_ATLAS_COLS * THUMB_SIZE, THUMB_ATLAS_ROWS * THUMB_SIZE,
+                 0, GL_RGBA, GL_UNSIGNED_BYTE, 0);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    startThumbnailJobs();
+}
+
+// Camera position on its orbit around the atom
+void cameraEye(float* eye) {
+    float radY = camAngleY * PI / 180.0f;
+    float radX = camAngleX * PI / 180.0f;
+
+    eye[0] = camDist * cosf(radX) * sinf(radY);
+    eye[1] = camDist * sinf(radX);
+    eye[2] = camDist * cosf(radX) * cosf(radY);
 }
 
 // Setup 3D camera
@@ -243,50 +780,421 @@ void setCamera3D() {
     glMatrixMode(GL_MODELVIEW);
     glLoadIdentity();
 
-    float radY = camAngleY * PI / 180.0f;
-    float radX = camAngleX * PI / 180.0f;
-
-    float eyeX = camDist * cosf(radX) * sinf(radY);
-    float eyeY = camDist * sinf(radX);
-    float eyeZ = camDist * cosf(radX) * cosf(radY);
+    float eye[3];
+    cameraEye(eye);
 
-    gluLookAt(eyeX, eyeY, eyeZ,
+    gluLookAt(eye[0], eye[1], eye[2],
               0.0f, 0.0f, 0.0f,
               0.0f, 1.0f, 0.0f);
 }
 
-// Build electrons from element info (automatic shells)
+// Build electrons from element info (automatic shells): neutral ground state
 void setupElectronsFromElement(const ElementInfo& e) {
-    numElectrons = 0;
+    if (sceneShells) {
+        int first = sceneShellIndex[e.Z - 1];
+        numElectrons = sceneShellIndex[e.Z] - first;
+        memcpy(electrons, sceneShells + first, numElectrons * sizeof(Electron));
+    } else {
+        numElectrons = buildElectronShells(e, electrons);
+    }
+
+    resetShellState(numElectrons);
+    ionCharge = 0;
+}
+
+// Shell bookkeeping for 'count' ground-state electrons, nothing in flight
+void resetShellState(int count) {
+    groundShellCounts(count, shellCount);
+    for (int s = 0; s < NUM_SHELLS; ++s) {
+        shellDirty[s] = false;
+        shellAnimating[s] = false;
+    }
+    for (int i = 0; i < MAX_ELECTRONS; ++i) {
+        electronTweens[i].t = 1.0f;
+        electronTweens[i].slide = 0.0f;
+    }
+    numEscaping = 0;
+}
+
+// Fill 'out' (MAX_ELECTRONS slots) with Bohr shells for e; returns count
+int buildElectronShells(const ElementInfo& e, Electron* out) {
+    return fillGroundShells(e.Z, out);
+}
+
+// Ground state for 'count' electrons: inner shells fill first, so the
+// result is already in slot layout
+int fillGroundShells(int count, Electron* out) {
+    int inShell[NUM_SHELLS];
+    groundShellCounts(count, inShell);
+
+    int n = 0;
+    for (int shell = 0; shell < NUM_SHELLS; ++shell) {
+        for (int i = 0; i < inShell[shell]; ++i) {
+            shellSlotElectron(shell, i, inShell[shell], out[n++]);
+        }
+    }
+    return n;
+}
+
+void groundShellCounts(int count, int* counts) {
+    for (int s = 0; s < NUM_SHELLS; ++s) {
+        counts[s] = std::min(count, shellCapacity[s]);
+        count -= counts[s];
+    }
+}
+
+// Electron i of inShell in a shell, evenly spaced from angle 0
+void shellSlotElectron(int shell, int i, int inShell, Electron& el) {
+    el.radius = SHELL_BASE_RADIUS + shell * SHELL_RADIUS_STEP;
+    el.angle  = (360.0f * i) / inShell;
+    el.speed  = SHELL_BASE_SPEED + 0.15f * shell + 0.02f * i;
+
+    // Different tilt for shells for 3D effect
+    el.tiltX  = (shell % 2 == 0) ? 25.0f + 5.0f * shell : -30.0f + 5.0f * shell;
+    el.tiltY  = (shell % 3 == 0) ? 0.0f  : 20.0f - 5.0f * shell;
+}
+
+// Advance every electron along its orbit by one timer tick
+void updateElectrons(Electron* list, int count, float stepScale) {
+    for (int i = 0; i < count; ++i) {
+        list[i].angle += list[i].speed * stepScale;
+        if (list[i].angle > 360.0f)
+            list[i].angle -= 360.0f;
+    }
+}
+
+// Bound electrons shell by shell (slots past a shell's count are unused),
+// plus the ones flying off after ionisation
+void advanceOrbits(float stepScale) {
+    for (int s = 0; s < NUM_SHELLS; ++s) {
+        updateElectrons(electrons + shellFirst[s], shellCount[s], stepScale);
+    }
+    for (int k = 0; k < numEscaping; ++k) {
+        updateElectrons(&escaping[k].e, 1, stepScale);
+    }
+}
+
+// --------------------------------------------------------
+// Ions and excited states (incremental shells)
+// --------------------------------------------------------
+// Every change below touches only the shells it moves electrons between;
+// the rest of electrons[] and every orbit display list stay as they are.
+
+// Where electron 'slot' is drawn: its orbit slot blended with its flight in
+void electronVisual(int slot, Electron& v) {
+    const ElectronTween &tw = electronTweens[slot];
+    v = electrons[slot];
+    v.angle += tw.slide;
+    if (tw.t < 1.0f) {
+        float k = tw.t * tw.t * (3.0f - 2.0f * tw.t);   // smoothstep
+        v.radius = tw.radius + (v.radius - tw.radius) * k;
+        v.tiltX  = tw.tiltX  + (v.tiltX  - tw.tiltX)  * k;
+        v.tiltY  = tw.tiltY  + (v.tiltY  - tw.tiltY)  * k;
+    }
+}
+
+// Put an electron in the next free slot of 'shell', flying in from 'from'
+// (or from outside the atom); returns the slot or -1 if the shell is full
+int addElectron(int shell, const Electron* from) {
+    if (shellCount[shell] >= shellCapacity[shell]) return -1;
+
+    int first = shellFirst[shell];
+    int i     = shellCount[shell]++;
+    int slot  = first + i;
+    Electron &el = electrons[slot];
+    ElectronTween &tw = electronTweens[slot];
+
+    shellSlotElectron(shell, i, i + 1, el);
+    tw.t = 0.0f;
+    tw.slide = 0.0f;
+    if (from) {
+        el.angle = from->angle;
+        tw.radius = from->radius;
+        tw.tiltX  = from->tiltX;
+        tw.tiltY  = from->tiltY;
+    } else {
+        if (i > 0) el.angle = fmodf(electrons[first].angle + el.angle, 360.0f);
+        tw.radius = el.radius + 25.0f;
+        tw.tiltX  = el.tiltX;
+        tw.tiltY  = el.tiltY;
+    }
+
+    numElectrons++;
+    ionCharge--;
+    shellDirty[shell] = true;
+    shellAnimating[shell] = true;
+    return slot;
+}
+
+// Take the last electron out of 'shell'; 'visual' gets where it was drawn
+bool removeElectron(int shell, Electron& visual) {
+    if (shellCount[shell] == 0) return false;
+
+    electronVisual(shellFirst[shell] + shellCount[shell] - 1, visual);
+    shellCount[shell]--;
+    numElectrons--;
+    ionCharge++;
+    shellDirty[shell] = true;
+    shellAnimating[shell] = true;
+    return true;
+}
+
+// Even spacing again after a change, keeping electron 0 where it is. The
+// jump is stored as a slide that eases out, so nothing snaps on screen
+void rebalanceShell(int shell) {
+    int first = shellFirst[shell];
+    int n = shellCount[shell];
+    if (n == 0) return;
+
+    float phase = electrons[first].angle + electronTweens[first].slide;
+    if (phase >= 360.0f)  phase -= 360.0f;
+    else if (phase < 0.0f) phase += 360.0f;
+    float step = 360.0f / n;
+
+    for (int i = 0; i < n; ++i) {
+        Electron &el = electrons[first + i];
+        ElectronTween &tw = electronTweens[first + i];
+
+        float target = phase + step * i;
+        if (target >= 360.0f) target -= 360.0f;
+
+        // Shortest way round; angle, slide and target are all within a turn
+        float d = el.angle + tw.slide - target;
+        while (d >= 180.0f)  d -= 360.0f;
+        while (d < -180.0f)  d += 360.0f;
+
+        el.angle = target;
+        tw.slide = d;
+    }
+}
+
+// Per timer tick: rebalance dirty shells, advance flights and slides
+void updateElectronShells(float dt) {
+    float flight = dt / ELECTRON_FLIGHT_S;
+    float decay  = expf(-6.0f * dt);
+
+    for (int s = 0; s < NUM_SHELLS; ++s) {
+        if (shellDirty[s]) {
+            rebalanceShell(s);
+            shellDirty[s] = false;
+        }
+        if (!shellAnimating[s] || dt <= 0.0f) continue;
+
+        bool settling = false;
+        for (int i = shellFirst[s]; i < shellFirst[s] + shellCount[s]; ++i) {
+            ElectronTween &tw = electronTweens[i];
+            if (tw.t < 1.0f) {
+                tw.t = std::min(tw.t + flight, 1.0f);
+                settling = true;
+            }
+            if (tw.slide != 0.0f) {
+                tw.slide *= decay;
+                if (fabsf(tw.slide) < 0.05f) tw.slide = 0.0f;
+                else settling = true;
+            }
+        }
+        shellAnimating[s] = settling;
+    }
+
+    for (int k = 0; k < numEscaping; ) {
+        escaping[k].t += flight;
+        if (escaping[k].t >= 1.0f) escaping[k] = escaping[--numEscaping];
+        else ++k;
+    }
+}
+
+// Remove the outermost electron (cation); it spirals away
+bool ionizeElectron() {
+    for (int s = NUM_SHELLS - 1; s >= 0; --s) {
+        Electron v;
+        if (!removeElectron(s, v)) continue;
+        if (numEscaping < MAX_ESCAPING) {
+            escaping[numEscaping].e = v;
+            escaping[numEscaping].t = 0.0f;
+            numEscaping++;
+        }
+        return true;
+    }
+    return false;
+}
+
+// Anion limit for Z: MAX_ANION_CHARGE, less near the end of the table where
+// the shells run out of slots (Og has none to spare)
+int maxAnionCharge(int Z) {
+    return std::max(0, std::min(MAX_ANION_CHARGE, SHELL_SLOTS - Z));
+}
+
+// Capture an electron into the innermost free slot (anion)
+bool captureElectron() {
+    const ElementInfo &e = elements[selectedIndex];
+    if (numElectrons >= e.Z + maxAnionCharge(e.Z)) return false;
+    for (int s = 0; s < NUM_SHELLS; ++s) {
+        if (addElectron(s, 0) >= 0) return true;
+    }
+    return false;
+}
+
+// Lift one more electron out of its ground shell: the outermost shell that
+// still holds only ground-state electrons and whose neighbour above has no
+// holes and has room. Already excited electrons stay put, so n calls
+// excite n electrons
+bool exciteElectron() {
+    int ground[NUM_SHELLS];
+    groundShellCounts(numElectrons, ground);
+
+    for (int s = NUM_SHELLS - 2; s >= 0; --s) {
+        if (shellCount[s] == 0 || shellCount[s] > ground[s] ||
+            shellCount[s + 1] < ground[s + 1] ||
+            shellCount[s + 1] >= shellCapacity[s + 1]) continue;
+        Electron v;
+        removeElectron(s, v);
+        addElectron(s + 1, &v);
+        return true;
+    }
+    return false;
+}
+
+// Drop excited electrons back down, one move per outer/inner shell pair;
+// returns how many moved
+int relaxElectrons() {
+    int ground[NUM_SHELLS];
+    groundShellCounts(numElectrons, ground);
+
+    int moved = 0;
+    for (;;) {
+        int inner = 0, outer = NUM_SHELLS - 1;
+        while (inner < NUM_SHELLS && shellCount[inner] >= ground[inner]) inner++;
+        while (outer >= 0 && shellCount[outer] <= ground[outer]) outer--;
+        if (inner == NUM_SHELLS || outer < 0) break;
+
+        Electron v;
+        removeElectron(outer, v);
+        addElectron(inner, &v);
+        moved++;
+    }
+    return moved;
+}
+
+// Step electrons in or out until the atom carries 'charge'
+void setIonCharge(int charge) {
+    int Z = elements[selectedIndex].Z;
+    charge = std::min(std::max(charge, -maxAnionCharge(Z)), Z);
+    while (ionCharge < charge && ionizeElectron()) {}
+    while (ionCharge > charge && captureElectron()) {}
+}
+
+// Switch the atom to another element keeping its charge: the electron
+// count changes by the difference in Z, so neighbours cost one electron
+void changeAtomElement(int elementIndex) {
+    int charge = ionCharge;
+    selectedIndex = elementIndex;
+    ionCharge = elements[selectedIndex].Z - numElectrons;
+    setIonCharge(charge);
+}
+
+// "Fe 2+ ion  |  shells: 2 8 14", plus "  |  excited" off the ground state
+void formatIonStatus(char* buf) {
+    const ElementInfo &e = elements[selectedIndex];
+    int n;
+    if (ionCharge == 0)     n = sprintf(buf, "%s neutral", e.symbol);
+    else if (ionCharge > 0) n = sprintf(buf, "%s %d+ ion", e.symbol, ionCharge);
+    else                    n = sprintf(buf, "%s %d- ion", e.symbol, -ionCharge);
+
+    int last = NUM_SHELLS - 1;
+    while (last > 0 && shellCount[last] == 0) last--;
+    n += sprintf(buf + n, "  |  shells:");
+    for (int s = 0; s <= last; ++s) {
+        n += sprintf(buf + n, " %d", shellCount[s]);
+    }
+
+    int ground[NUM_SHELLS];
+    groundShellCounts(numElectrons, ground);
+    if (memcmp(ground, shellCount, sizeof(ground)) != 0) sprintf(buf + n, "  |  excited");
+}
 
-    // Simple Bohr-style capacities for 7 shells, total ~118
-    int shellCap[7] = { 2, 8, 18, 32, 32, 18, 8 };
+// --------------------------------------------------------
+// Adaptive quality governor
+// --------------------------------------------------------
+double nowMs() {
+    using namespace std::chrono;
+    return duration<double, std::milli>(steady_clock::now().time_since_epoch()).count();
+}
 
-    int remaining = e.Z;
-    float baseRadius = 6.0f;      // innermost shell radius
-    float radiusStep = 3.0f;      // distance between shells
-    float baseSpeed  = 1.5f;      // base angular speed
+void setQualityLevel(int index, const char* reason) {
+    if (index < 0) index = 0;
+    if (index >= numQualityLevels) index = numQualityLevels - 1;
+    if (index == qualityIndex) return;
+
+    printf("[quality] %s -> %s (%s, avg frame %.2f ms, budget %.1f ms)\n",
+           qualityLevels[qualityIndex].name, qualityLevels[index].name,
+           reason, avgFrameMs, frameBudgetMs);
+    fflush(stdout);
+
+    lastQualityChangeUp = index > qualityIndex;
+    qualityIndex = index;
+    framesSinceQualityChange = 0;
+    overBudgetFrames  = 0;
+    underBudgetFrames = 0;
+}
 
-    for (int shell = 0; shell < 7 && remaining > 0; ++shell) {
-        int maxInShell = shellCap[shell];
-        int count = (remaining > maxInShell) ? maxInShell : remaining;
-        remaining -= count;
+// Feed one measured frame; steps quality down/up with hysteresis
+void updateQualityGovernor(float frameMs) {
+    // Table and atom frames cost different amounts: re-seed on a view switch
+    bool atom = (currentMode == MODE_ATOM);
+    if (avgFrameMs <= 0.0f || atom != governorInAtom) avgFrameMs = frameMs;
+    else avgFrameMs += GOV_SMOOTHING * (frameMs - avgFrameMs);
+    governorInAtom = atom;
+
+    // The quality knobs only affect the atom view; table frames are shown
+    // in the HUD but never move the level
+    if (!atom) {
+        overBudgetFrames  = 0;
+        underBudgetFrames = 0;
+        return;
+    }
 
-        float radius = baseRadius + shell * radiusStep;
+    framesSinceQualityChange++;
+    if (framesSinceQualityChange >= GOV_STABLE_FRAMES) upgradeBackoff = 1;
+    if (!governorEnabled) return;
 
-        for (int i = 0; i < count && numElectrons < MAX_ELECTRONS; ++i) {
-            Electron &el = electrons[numElectrons++];
-            el.radius = radius;
-            el.angle  = (360.0f * i) / count;
-            el.speed  = baseSpeed + 0.15f * shell + 0.02f * i;
+    if (avgFrameMs > frameBudgetMs * GOV_DOWN_RATIO) {
+        overBudgetFrames++;
+        underBudgetFrames = 0;
+    } else if (avgFrameMs < frameBudgetMs * GOV_UP_RATIO) {
+        underBudgetFrames++;
+        overBudgetFrames = 0;
+    } else {
+        // inside the band: hold the current level
+        overBudgetFrames  = 0;
+        underBudgetFrames = 0;
+    }
 
-            // Different tilt for shells for 3D effect
-            el.tiltX  = (shell % 2 == 0) ? 25.0f + 5.0f * shell : -30.0f + 5.0f * shell;
-            el.tiltY  = (shell % 3 == 0) ? 0.0f  : 20.0f - 5.0f * shell;
+    if (overBudgetFrames >= GOV_DOWN_FRAMES && qualityIndex > 0) {
+        // Upgrade that could not be sustained -> wait longer before trying again
+        if (lastQualityChangeUp && framesSinceQualityChange < 2 * GOV_UP_FRAMES) {
+            if (upgradeBackoff < 16) upgradeBackoff *= 2;
         }
+        setQualityLevel(qualityIndex - 1, "over budget");
+    }
+    else if (underBudgetFrames >= GOV_UP_FRAMES * upgradeBackoff &&
+             qualityIndex < numQualityLevels - 1) {
+        setQualityLevel(qualityIndex + 1, "headroom");
     }
 }
 
+// Timer period: never tick faster than the frame budget allows
+int animationTimerMs() {
+    int ms = qualityLevels[qualityIndex].timerMs;
+    if (ms < (int)frameBudgetMs) ms = (int)frameBudgetMs;
+    return ms;
+}
+
+void formatQualityStatus(char* buf) {
+    sprintf(buf, "Quality: %s (%d/%d, %s)  |  frame %.2f ms / budget %.1f ms  |  Q = auto/manual, [ ] = step",
+            qualityLevels[qualityIndex].name, qualityIndex + 1, numQualityLevels,
+            governorEnabled ? "auto" : "manual", avgFrameMs, frameBudgetMs);
+}
+
 // --------------------------------------------------------
 // Drawing helpers
 // --------------------------------------------------------
@@ -302,22 +1210,23 @@ void putPixel(float x, float y) {
     glVertex2f(x, y);
 }
 
-void drawLineDDA(float x1, float y1, float x2, float y2) {
+// Walk the line with DDA and hand each point to 'plot'; returns point count
+int rasterLineDDA(float x1, float y1, float x2, float y2, void (*plot)(float, float)) {
     float dx = x2 - x1;
     float dy = y2 - y1;
+    int points = 0;
 
     // Handle vertical line separately to avoid division by zero
     if (dx == 0) {
         float y = y1;
         float yStep = (dy > 0) ? 1.0f : -1.0f;
 
-        glBegin(GL_POINTS);
         while ((yStep > 0 && y <= y2) || (yStep < 0 && y >= y2)) {
-            putPixel(x1, y);
+            plot(x1, y);
+            points++;
             y += yStep;
         }
-        glEnd();
-        return;
+        return points;
     }
 
     float m = dy / dx;   // slope
@@ -325,14 +1234,13 @@ void drawLineDDA(float x1, float y1, float x2, float y2) {
     float x = x1;
     float y = y1;
 
-    glBegin(GL_POINTS);
-
     // -------- Case 1: |Δx| ≥ |Δy| --------
     if (fabsf(dx) >= fabsf(dy)) {
         float xStep = (dx > 0) ? 1.0f : -1.0f;
 
         while ((xStep > 0 && x <= x2) || (xStep < 0 && x >= x2)) {
-            putPixel(x, y);
+            plot(x, y);
+            points++;
             x = x + xStep;   // x(i+1) = x(i) + 1
             y = y + m;       // y(i+1) = y(i) + m
         }
@@ -342,12 +1250,19 @@ void drawLineDDA(float x1, float y1, float x2, float y2) {
         float yStep = (dy > 0) ? 1.0f : -1.0f;
 
         while ((yStep > 0 && y <= y2) || (yStep < 0 && y >= y2)) {
-            putPixel(x, y);
+            plot(x, y);
+            points++;
             y = y + yStep;   // y(i+1) = y(i) + 1
             x = x + (1.0f / m); // x(i+1) = x(i) + 1/m
         }
     }
 
+    return points;
+}
+
+void drawLineDDA(float x1, float y1, float x2, float y2) {
+    glBegin(GL_POINTS);
+    rasterLineDDA(x1, y1, x2, y2, putPixel);
     glEnd();
 }
 
@@ -363,29 +1278,13 @@ void drawRectDDA(float x, float y, float w, float h) {
     drawLineDDA(x2, y,  x2, y2);
 }
 
-// Periodic table with real group positions, lanth/act rows separate
-void drawPeriodicTable() {
-    glDisable(GL_LIGHTING);  // flat 2D for UI
-
+// Cell positions with real group positions, lanth/act rows separate
+void layoutPeriodicTable() {
     cellCount = 0;
 
-    // Background
-    glColor3f(0.05f, 0.05f, 0.15f);
-    glBegin(GL_QUADS);
-    glVertex2f(0.0f, 0.0f);
-    glVertex2f(100.0f, 0.0f);
-    glVertex2f(100.0f, 100.0f);
-    glVertex2f(0.0f, 100.0f);
-    glEnd();
-
-    // Title
-    glColor3f(1.0f, 1.0f, 0.8f);
-    drawText2D(20.0f, 94.0f, "Interactive Periodic Table (118 Elements, Lanthanides & Actinides Separate)",
-               GLUT_BITMAP_HELVETICA_12);
-
-    float startX = 5.0f;
-    float cellW  = 3.5f;
-    float rowH   = 6.5f;
+    float startX = TABLE_START_X;
+    float cellW  = TABLE_CELL_W;
+    float rowH   = TABLE_ROW_H;
 
     // Main periods 1–7
     for (int i = 0; i < numElements; ++i) {
@@ -397,18 +1296,18 @@ void drawPeriodicTable() {
             // main table as group/period
             if (e.group <= 0) continue; // should not happen
             x = startX + (e.group - 1) * cellW;
-            float baseY = 88.0f;
+            float baseY = TABLE_TOP_Y;
             y = baseY - (e.period - 1) * rowH;
         } else if (e.blockRow == 1) {
             // lanthanides row
             float lanthStartX = startX + (3 - 1) * cellW;
             x = lanthStartX + e.blockCol * cellW;
-            y = 25.0f;
+            y = TABLE_LANTH_Y;
         } else { // blockRow == 2
             // actinides row
             float actStartX = startX + (3 - 1) * cellW;
             x = actStartX + e.blockCol * cellW;
-            y = 18.0f;
+            y = TABLE_ACT_Y;
         }
 
         float cellH = rowH - 1.0f;
@@ -419,244 +1318,2365 @@ void drawPeriodicTable() {
         cellRects[cellCount].h = cellH;
         cellRects[cellCount].elementIndex = i;
         cellCount++;
+    }
+}
 
-        // Fill color
-        if (i == selectedIndex)
-            glColor3f(1.0f, 0.8f, 0.2f);  // selected = yellow
-        else if (e.blockRow == 1 || e.blockRow == 2)
-            glColor3f(0.3f, 0.5f, 0.9f);  // f-block slightly different
-        else
-            glColor3f(0.2f, 0.4f, 0.8f);  // normal
+// Element index under a point in table space (0..100), or -1
+int hitTestTable(float fx, float fy) {
+    for (int i = 0; i < cellCount; ++i) {
+        CellRect &c = cellRects[i];
+        if (fx >= c.x && fx <= c.x + c.w &&
+            fy >= c.y && fy <= c.y + c.h) {
+            return c.elementIndex;
+        }
+    }
+    return -1;
+}
 
-        glBegin(GL_QUADS);
-        glVertex2f(x,         y);
-        glVertex2f(x + cellW, y);
-        glVertex2f(x + cellW, y + cellH);
-        glVertex2f(x,         y + cellH);
-        glEnd();
+// --------------------------------------------------------
+// Table view: zoom/pan, level of detail, property heatmaps
+// --------------------------------------------------------
 
-        // DDA border for selected element
-        if (i == selectedIndex) {
-            glColor3f(1.0f, 1.0f, 1.0f); // white border
-            drawRectDDA(x, y, cellW, cellH);
+// Aufbau (Madelung) configuration with the well-known exceptions
+void buildElementConfigs() {
+    static const char* subshells[] = { "1s", "2s", "2p", "3s", "3p", "4s", "3d", "4p", "5s",
+                                       "4d", "5p", "6s", "4f", "5d", "6p", "7s", "5f", "6d", "7p" };
+    static const int capacity[] = { 2, 2, 6, 2, 6, 2, 10, 6, 2, 10, 6, 2, 14, 10, 6, 2, 14, 10, 6 };
+    static const int nobleZ[] = { 86, 54, 36, 18, 10, 2 };
+    static const char* nobleSym[] = { "[Rn]", "[Xe]", "[Kr]", "[Ar]", "[Ne]", "[He]" };
+
+    // Exceptions, written in the same Madelung order as the computed ones
+    static const struct { int Z; const char* config; } exceptions[] = {
+        { 24, "[Ar] 4s1 3d5" },          { 29, "[Ar] 4s1 3d10" },
+        { 41, "[Kr] 5s1 4d4" },          { 42, "[Kr] 5s1 4d5" },
+        { 44, "[Kr] 5s1 4d7" },          { 45, "[Kr] 5s1 4d8" },
+        { 46, "[Kr] 4d10" },             { 47, "[Kr] 5s1 4d10" },
+        { 57, "[Xe] 6s2 5d1" },          { 58, "[Xe] 6s2 4f1 5d1" },
+        { 64, "[Xe] 6s2 4f7 5d1" },      { 78, "[Xe] 6s1 4f14 5d9" },
+        { 79, "[Xe] 6s1 4f14 5d10" },    { 89, "[Rn] 7s2 6d1" },
+        { 90, "[Rn] 7s2 6d2" },          { 91, "[Rn] 7s2 5f2 6d1" },
+        { 92, "[Rn] 7s2 5f3 6d1" },      { 93, "[Rn] 7s2 5f4 6d1" },
+        { 96, "[Rn] 7s2 5f7 6d1" },      { 103, "[Rn] 7s2 5f14 7p1" }
+    };
+
+    for (int i = 0; i < numElements; ++i) {
+        int Z = elements[i].Z;
+        char* out = elementConfig[i];
+        out[0] = '\0';
+
+        bool special = false;
+        for (unsigned int k = 0; k < sizeof(exceptions) / sizeof(exceptions[0]); ++k) {
+            if (exceptions[k].Z == Z) {
+                strcpy(out, exceptions[k].config);
+                special = true;
+            }
+        }
+        if (special) continue;
+
+        // Noble-gas core, then fill the remaining subshells in order
+        int core = 0;
+        for (int k = 0; k < 6; ++k) {
+            if (nobleZ[k] < Z) {
+                core = nobleZ[k];
+                strcpy(out, nobleSym[k]);
+                break;
+            }
         }
 
-        // Symbol text
-        glColor3f(1.0f, 1.0f, 1.0f);
-        drawText2D(x + 0.6f, y + 2.3f, e.symbol, GLUT_BITMAP_HELVETICA_10);
+        int filled = 0;
+        for (int k = 0; k < 19 && filled < Z; ++k) {
+            int n = std::min(capacity[k], Z - filled);
+            filled += n;
+            if (filled <= core) continue;
+            char part[16];
+            sprintf(part, "%s%s%d", out[0] ? " " : "", subshells[k], n);
+            strcat(out, part);
+        }
     }
+}
 
-    // Info for selected element
-    ElementInfo &sel = elements[selectedIndex];
-
-    char info[256];
-        char groupTxt[32];
-    if (sel.group > 0) {
-        sprintf(groupTxt, "%d", sel.group);
-    } else {
-        sprintf(groupTxt, "f-block");
+float elementPropertyValue(int mode, int i) {
+    const ElementProps &p = elementProps[i];
+    switch (mode) {
+        case COLOR_ELECTRONEGATIVITY: return p.electronegativity;
+        case COLOR_RADIUS:            return p.radius;
+        case COLOR_DENSITY:           return p.density > 0.0f ? log10f(p.density) : -100.0f;
+        case COLOR_MASS:              return p.mass;
     }
+    return 0.0f;
+}
 
-    sprintf(info, "Selected: %s (%s), Z = %d, Period = %d, Group = %s",
-            sel.name, sel.symbol, sel.Z, sel.period, groupTxt);
-
+// Blue -> teal -> green -> yellow -> red
+void heatColor(float t, float* rgb) {
+    static const float stops[5][3] = {
+        { 0.15f, 0.20f, 0.65f }, { 0.10f, 0.60f, 0.75f }, { 0.20f, 0.70f, 0.30f },
+        { 0.95f, 0.80f, 0.20f }, { 0.85f, 0.20f, 0.15f }
+    };
+    t = std::min(std::max(t, 0.0f), 1.0f) * 4.0f;
+    int k = std::min((int)t, 3);
+    float f = t - k;
+    for (int c = 0; c < 3; ++c) {
+        rgb[c] = stops[k][c] + (stops[k + 1][c] - stops[k][c]) * f;
+    }
+}
 
-    glColor3f(0.8f, 1.0f, 0.8f);
-    drawText2D(5.0f, 10.0f, info, GLUT_BITMAP_HELVETICA_12);
+// Normalised values and colours for every property, computed once
+void buildPropertyColors() {
+    for (int i = 0; i < numElements; ++i) {
+        const ElementInfo &e = elements[i];
+        float* rgb = propertyColors[COLOR_CATEGORY][i];
+        if (e.blockRow == 1 || e.blockRow == 2) { rgb[0] = 0.3f; rgb[1] = 0.5f; rgb[2] = 0.9f; }
+        else                                    { rgb[0] = 0.2f; rgb[1] = 0.4f; rgb[2] = 0.8f; }
+        propertyNorm[COLOR_CATEGORY][i] = -1.0f;
+    }
 
-    glColor3f(0.8f, 0.8f, 0.8f);
-    drawText2D(5.0f, 5.0f,
-               "LEFT/RIGHT: change element  |  Mouse click: select  |  'A': Atom View",
-               GLUT_BITMAP_HELVETICA_10);
+    for (int mode = COLOR_ELECTRONEGATIVITY; mode < NUM_COLOR_MODES; ++mode) {
+        float lo = 0.0f, hi = 0.0f;
+        bool any = false;
+        for (int i = 0; i < numElements; ++i) {
+            float v = elementPropertyValue(mode, i);
+            bool known = (mode == COLOR_DENSITY) ? v > -100.0f : v > 0.0f;
+            if (!known) continue;
+            if (!any || v < lo) lo = v;
+            if (!any || v > hi) hi = v;
+            any = true;
+        }
+        propertyMin[mode] = lo;
+        propertyMax[mode] = hi;
+
+        for (int i = 0; i < numElements; ++i) {
+            float v = elementPropertyValue(mode, i);
+            bool known = (mode == COLOR_DENSITY) ? v > -100.0f : v > 0.0f;
+            float* rgb = propertyColors[mode][i];
+            if (!known || hi <= lo) {
+                propertyNorm[mode][i] = -1.0f;
+                rgb[0] = 0.30f; rgb[1] = 0.30f; rgb[2] = 0.35f;   // no data
+                continue;
+            }
+            propertyNorm[mode][i] = (v - lo) / (hi - lo);
+            heatColor(propertyNorm[mode][i], rgb);
+        }
+    }
 
-    glEnable(GL_LIGHTING);
+    for (int i = 0; i < numElements; ++i) {
+        memcpy(colorFrom[i], propertyColors[colorMode][i], sizeof(colorFrom[i]));
+    }
 }
 
-// Nucleus drawing (simple cluster)
-void drawNucleus(const ElementInfo& e) {
-    int Z = e.Z;
-
-    int neutrons;
-
-    // Rough neutron/proton ratio: light ~1.0, medium ~1.3, heavy ~1.5
-    if (Z == 1) {
-        neutrons = 0;
-    } else {
-    float nOverZ;
-    if (Z <= 20)       nOverZ = 1.0f;
-    else if (Z <= 40)  nOverZ = 1.2f;
-    else if (Z <= 82)  nOverZ = 1.4f;
-    else               nOverZ = 1.5f;
+// Fill colour of a cell, mid-transition if one is running
+void cellColor(int i, float* rgb) {
+    const float* to = propertyColors[colorMode][i];
+    float t = colorBlend * colorBlend * (3.0f - 2.0f * colorBlend);   // smoothstep
+    for (int c = 0; c < 3; ++c) {
+        rgb[c] = colorFrom[i][c] + (to[c] - colorFrom[i][c]) * t;
+    }
+}
 
-    neutrons = (int)(nOverZ * Z);
+void setColorMode(int mode) {
+    // Start the new transition from whatever is on screen now
+    for (int i = 0; i < numElements; ++i) {
+        cellColor(i, colorFrom[i]);
     }
-    int totalNucleons = Z + neutrons;
+    colorMode  = (ColorMode)(mode % NUM_COLOR_MODES);
+    colorBlend = 0.0f;
+}
 
+void tableViewRect(const TableView& v, float& left, float& bottom, float& width, float& height) {
+    width  = 100.0f / v.zoom;
+    height = 100.0f / v.zoom;
+    left   = v.cx - width  * 0.5f;
+    bottom = v.cy - height * 0.5f;
+}
 
-    const int MAX_NUCLEONS_DRAW = 60;
-    int drawProtons  = Z;
-    int drawNeutrons = neutrons;
+// Window pixel (GLUT, y down) -> table space under the current view
+void windowToTable(int x, int y, float& fx, float& fy) {
+    int width  = glutGet(GLUT_WINDOW_WIDTH);
+    int height = glutGet(GLUT_WINDOW_HEIGHT);
+    if (width <= 0)  width  = 1;
+    if (height <= 0) height = 1;
 
-    if (totalNucleons > MAX_NUCLEONS_DRAW) {
-        float factor = (float)MAX_NUCLEONS_DRAW / (float)totalNucleons;
-        drawProtons  = (int)(Z * factor);
-        drawNeutrons = MAX_NUCLEONS_DRAW - drawProtons;
-    }
+    float left, bottom, vw, vh;
+    tableViewRect(tableView, left, bottom, vw, vh);
+    fx = left   + (float)x * vw / width;
+    fy = bottom + (float)(height - y) * vh / height;
+}
 
+// Keep at least half a screen of table in view
+void clampTableView(TableView& v) {
+    v.zoom = std::min(std::max(v.zoom, 1.0f), TABLE_MAX_ZOOM);
+    float half = 50.0f / v.zoom;
+    v.cx = std::min(std::max(v.cx, half), 100.0f - half);
+    v.cy = std::min(std::max(v.cy, half), 100.0f - half);
+}
 
-    float clusterRadius = 3.0f + 0.01f * Z;
-    float sphereRadius  = 0.4f;
+// Zoom the target view, keeping table point (fx, fy) fixed on screen
+void zoomTableAt(float fx, float fy, float factor) {
+    float oldZoom = tableViewTarget.zoom;
+    float newZoom = std::min(std::max(oldZoom * factor, 1.0f), TABLE_MAX_ZOOM);
+    tableViewTarget.cx = fx + (tableViewTarget.cx - fx) * oldZoom / newZoom;
+    tableViewTarget.cy = fy + (tableViewTarget.cy - fy) * oldZoom / newZoom;
+    tableViewTarget.zoom = newZoom;
+    clampTableView(tableViewTarget);
+}
 
+// Ease in on one cell until it fills most of the window height
+void zoomToCell(int elementIndex) {
+    for (int c = 0; c < cellCount; ++c) {
+        const CellRect &cell = cellRects[c];
+        if (cell.elementIndex != elementIndex) continue;
+        tableViewTarget.cx   = cell.x + cell.w * 0.5f;
+        tableViewTarget.cy   = cell.y + cell.h * 0.5f;
+        tableViewTarget.zoom = 60.0f / cell.h;
+        clampTableView(tableViewTarget);
+        return;
+    }
+}
 
-    srand(e.Z);
+// Per timer tick: ease the view and advance colour transitions
+void updateTableView(float dt) {
+    float k = 1.0f - expf(-10.0f * dt);
+    tableView.cx   += (tableViewTarget.cx   - tableView.cx)   * k;
+    tableView.cy   += (tableViewTarget.cy   - tableView.cy)   * k;
+    tableView.zoom += (tableViewTarget.zoom - tableView.zoom) * k;
 
-    // --- Draw protons (red) ---
-    glColor3f(1.0f, 0.2f, 0.2f);
-    for (int i = 0; i < drawProtons; ++i) {
-        float u = (float)rand() / (float)RAND_MAX;
-        float v = (float)rand() / (float)RAND_MAX;
-        float w = (float)rand() / (float)RAND_MAX;
+    if (colorBlend < 1.0f) colorBlend = std::min(colorBlend + dt / 0.6f, 1.0f);
+}
 
-        float theta = 2.0f * PI * u;
-        float phi   = acosf(2.0f * v - 1.0f);
-        float r     = cbrtf(w);  // cube root for uniform distribution in volume
+// Atom pictures from the atlas, one textured quad per visible ready cell
+// (rects are window pixels: x, y, w, h per visible cell)
+void drawCellThumbnails(const float* rects, const int* cells, int count, int lod) {
+    uploadReadyThumbnails();
 
-        float x = r * sinf(phi) * cosf(theta);
-        float y = r * sinf(phi) * sinf(theta);
-        float z = r * cosf(phi);
+    glEnable(GL_TEXTURE_2D);
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    glTexEnvi(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_MODULATE);
+    glBindTexture(GL_TEXTURE_2D, thumbAtlasTex);
+    glColor3f(1.0f, 1.0f, 1.0f);
 
-        x *= clusterRadius;
-        y *= clusterRadius;
-        z *= clusterRadius;
+    const float du = 1.0f / THUMB_ATLAS_COLS;
+    const float dv = 1.0f / THUMB_ATLAS_ROWS;
+
+    glBegin(GL_QUADS);
+    for (int k = 0; k < count; ++k) {
+        int i = cellRects[cells[k]].elementIndex;
+        if (!thumbInAtlas[i]) continue;
+
+        const float* r = rects + k * 4;
+        float side, x, y;
+        if (lod == 0) {
+            // Area above the symbol line
+            side = std::min(r[2] - 4.0f, r[3] * (3.3f / 5.5f));
+            x = r[0] + (r[2] - side) * 0.5f;
+        } else {
+            side = detailThumbSide(r);
+            x = r[0] + r[2] - side - 4.0f;
+        }
+        y = r[1] + r[3] - side - 3.0f;
+
+        float u = (i % THUMB_ATLAS_COLS) * du;
+        float v = (i / THUMB_ATLAS_COLS) * dv;
+        glTexCoord2f(u,      v);      glVertex2f(x,        y);
+        glTexCoord2f(u + du, v);      glVertex2f(x + side, y);
+        glTexCoord2f(u + du, v + dv); glVertex2f(x + side, y + side);
+        glTexCoord2f(u,      v + dv); glVertex2f(x,        y + side);
+    }
+    glEnd();
+
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glDisable(GL_BLEND);
+    glDisable(GL_TEXTURE_2D);
+}
+
+// Thumbnail in the top-right corner of a detailed cell; beyond ~3x the
+// tile size it only gets blurrier
+float detailThumbSide(const float* r) {
+    return std::min(std::min(r[2], r[3]) * 0.4f, THUMB_SIZE * 3.0f);
+}
+
+// Name, mass, configuration and property bars, depending on lod
+void drawCellDetails(int i, const float* r, int lod) {
+    const ElementInfo  &e = elements[i];
+    const ElementProps &p = elementProps[i];
+    const float pad = 6.0f;
+    float x   = r[0] + pad;
+    float top = r[1] + r[3] - pad;
+    char line[96];
+
+    glColor3f(1.0f, 1.0f, 1.0f);
+    drawText2D(x, top - 16.0f, e.symbol, GLUT_BITMAP_HELVETICA_18);
+
+    sprintf(line, "%d", e.Z);
+    glColor3f(0.85f, 0.9f, 1.0f);
+    drawText2D(x, top - 32.0f, line, GLUT_BITMAP_HELVETICA_10);
+
+    if (lod == 1) {
+        drawText2D(x, r[1] + pad, e.name, GLUT_BITMAP_HELVETICA_10);
+        return;
+    }
+
+    // Longer lines start below the thumbnail
+    float y = std::min(top - 48.0f, top - detailThumbSide(r) - 16.0f);
+    drawText2D(x, y, e.name, GLUT_BITMAP_HELVETICA_12);
+
+    if (p.mass == floorf(p.mass)) sprintf(line, "[%d] u", (int)p.mass);   // most stable isotope
+    else                          sprintf(line, "%.3f u", p.mass);
+    drawText2D(x, y - 15.0f, line, GLUT_BITMAP_HELVETICA_10);
+    drawText2D(x, y - 29.0f, elementConfig[i], GLUT_BITMAP_HELVETICA_10);
+
+    if (lod < 3) return;
+
+    // One bar per property, scaled to the range across the whole table
+    static const char* labels[] = { "", "EN", "Radius", "Density", "Mass" };
+    float barX = x + 48.0f;
+    float barW = r[0] + r[2] - pad - barX;
+    for (int mode = COLOR_ELECTRONEGATIVITY; mode < NUM_COLOR_MODES; ++mode) {
+        y = r[1] + pad + (NUM_COLOR_MODES - 1 - mode) * 14.0f;
+        float t = propertyNorm[mode][i];
+
+        glColor3f(0.85f, 0.9f, 1.0f);
+        drawText2D(x, y + 2.0f, labels[mode], GLUT_BITMAP_HELVETICA_10);
+
+        glColor3f(0.1f, 0.1f, 0.2f);
+        glBegin(GL_QUADS);
+        glVertex2f(barX, y);          glVertex2f(barX + barW, y);
+        glVertex2f(barX + barW, y + 10.0f); glVertex2f(barX, y + 10.0f);
+        glEnd();
+
+        if (t < 0.0f) continue;   // no data
+        float rgb[3];
+        heatColor(t, rgb);
+        glColor3fv(rgb);
+        float w = std::max(barW * t, 2.0f);
+        glBegin(GL_QUADS);
+        glVertex2f(barX, y);          glVertex2f(barX + w, y);
+        glVertex2f(barX + w, y + 10.0f); glVertex2f(barX, y + 10.0f);
+        glEnd();
+    }
+}
+
+// Visible cells under tableView as window-pixel rects (x, y, w, h);
+// returns the count and the level of detail for the frame
+int cullTableCells(int winW, int winH, int* visible, float* rects, int& lod) {
+    float left, bottom, vw, vh;
+    tableViewRect(tableView, left, bottom, vw, vh);
+    float sx = winW / vw, sy = winH / vh;
+
+    int numVisible = 0;
+    for (int c = 0; c < cellCount; ++c) {
+        const CellRect &cell = cellRects[c];
+        float x = (cell.x - left) * sx, y = (cell.y - bottom) * sy;
+        float w = cell.w * sx, h = cell.h * sy;
+        if (x + w < 0.0f || y + h < 0.0f || x > winW || y > winH) continue;
+
+        visible[numVisible] = c;
+        rects[numVisible * 4 + 0] = x;
+        rects[numVisible * 4 + 1] = y;
+        rects[numVisible * 4 + 2] = w;
+        rects[numVisible * 4 + 3] = h;
+        numVisible++;
+    }
+
+    // One level of detail for the frame: all cells are the same size
+    float cellPx = cellRects[0].w * sx;
+    lod = cellPx >= LOD_CHARTS_PX ? 3 : cellPx >= LOD_DETAIL_PX ? 2 : cellPx >= LOD_NAME_PX ? 1 : 0;
+    return numVisible;
+}
+
+// Periodic table drawn from the precomputed cell layout through the zoom view
+void drawPeriodicTable() {
+    glDisable(GL_LIGHTING);  // flat 2D for UI
+
+    // Background
+    glColor3f(0.05f, 0.05f, 0.15f);
+    glBegin(GL_QUADS);
+    glVertex2f(0.0f, 0.0f);
+    glVertex2f(100.0f, 0.0f);
+    glVertex2f(100.0f, 100.0f);
+    glVertex2f(0.0f, 100.0f);
+    glEnd();
+
+    // Cells are drawn in window pixels so text and DDA borders stay crisp
+    int winW = glutGet(GLUT_WINDOW_WIDTH);
+    int winH = glutGet(GLUT_WINDOW_HEIGHT);
+    if (winW <= 0) winW = 1;
+    if (winH <= 0) winH = 1;
+
+    glMatrixMode(GL_PROJECTION);
+    glPushMatrix();
+    glLoadIdentity();
+    gluOrtho2D(0, winW, 0, winH);
+    glMatrixMode(GL_MODELVIEW);
+
+    // Cull to the viewport; everything below only touches visible cells
+    static int   visible[200];
+    static float rects[200 * 4];
+    int lod;
+    int numVisible = cullTableCells(winW, winH, visible, rects, lod);
+
+    glBegin(GL_QUADS);
+    for (int k = 0; k < numVisible; ++k) {
+        int i = cellRects[visible[k]].elementIndex;
+        const float* r = rects + k * 4;
+
+        float rgb[3];
+        cellColor(i, rgb);
+        if (i == selectedIndex && colorMode == COLOR_CATEGORY)
+            glColor3f(1.0f, 0.8f, 0.2f);  // selected = yellow
+        else
+            glColor3fv(rgb);
+
+        glVertex2f(r[0],        r[1]);
+        glVertex2f(r[0] + r[2], r[1]);
+        glVertex2f(r[0] + r[2], r[1] + r[3]);
+        glVertex2f(r[0],        r[1] + r[3]);
+    }
+    glEnd();
+
+    drawCellThumbnails(rects, visible, numVisible, lod);
+
+    for (int k = 0; k < numVisible; ++k) {
+        int i = cellRects[visible[k]].elementIndex;
+        const float* r = rects + k * 4;
+
+        if (lod == 0) {
+            // Symbol text (below the thumbnail)
+            glColor3f(1.0f, 1.0f, 1.0f);
+            drawText2D(r[0] + r[2] * 0.17f, r[1] + r[3] * 0.13f, elements[i].symbol,
+                       GLUT_BITMAP_HELVETICA_10);
+        } else {
+            drawCellDetails(i, r, lod);
+        }
+
+        // DDA border for selected element
+        if (i == selectedIndex) {
+            glColor3f(1.0f, 1.0f, 1.0f); // white border
+            drawRectDDA(r[0], r[1], r[2], r[3]);
+        }
+    }
+
+    glMatrixMode(GL_PROJECTION);
+    glPopMatrix();
+    glMatrixMode(GL_MODELVIEW);
+
+    // Screen-fixed HUD; keep it readable over zoomed-in cells
+    if (tableView.zoom > 1.01f) {
+        glEnable(GL_BLEND);
+        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        glColor4f(0.02f, 0.02f, 0.08f, 0.8f);
+        glBegin(GL_QUADS);
+        glVertex2f(0.0f, 0.0f);    glVertex2f(100.0f, 0.0f);
+        glVertex2f(100.0f, 13.5f); glVertex2f(0.0f, 13.5f);
+        glVertex2f(0.0f, 92.0f);   glVertex2f(100.0f, 92.0f);
+        glVertex2f(100.0f, 100.0f); glVertex2f(0.0f, 100.0f);
+        glEnd();
+        glDisable(GL_BLEND);
+    }
+
+    // Title
+    glColor3f(1.0f, 1.0f, 0.8f);
+    drawText2D(20.0f, 94.0f, "Interactive Periodic Table (118 Elements, Lanthanides & Actinides Separate)",
+               GLUT_BITMAP_HELVETICA_12);
+
+    // Heatmap legend
+    if (colorMode != COLOR_CATEGORY) {
+        glBegin(GL_QUADS);
+        for (int k = 0; k < 20; ++k) {
+            float rgb[3];
+            heatColor((k + 0.5f) / 20.0f, rgb);
+            glColor3fv(rgb);
+            float x0 = 70.0f + k * 1.25f;
+            glVertex2f(x0, 97.0f);         glVertex2f(x0 + 1.25f, 97.0f);
+            glVertex2f(x0 + 1.25f, 98.5f); glVertex2f(x0, 98.5f);
+        }
+        glEnd();
+
+        char legend[96];
+        float lo = propertyMin[colorMode], hi = propertyMax[colorMode];
+        if (colorMode == COLOR_DENSITY) { lo = powf(10.0f, lo); hi = powf(10.0f, hi); }
+        sprintf(legend, "%s: %.4g - %.4g", colorModeNames[colorMode], lo, hi);
+        glColor3f(0.9f, 0.9f, 0.9f);
+        drawText2D(70.0f, 94.0f, legend, GLUT_BITMAP_HELVETICA_10);
+    }
+
+    // Info for selected element
+    ElementInfo &sel = elements[selectedIndex];
+
+    char info[256];
+        char groupTxt[32];
+    if (sel.group > 0) {
+        sprintf(groupTxt, "%d", sel.group);
+    } else {
+        sprintf(groupTxt, "f-block");
+    }
+
+    sprintf(info, "Selected: %s (%s), Z = %d, Period = %d, Group = %s",
+            sel.name, sel.symbol, sel.Z, sel.period, groupTxt);
+
+
+    glColor3f(0.8f, 1.0f, 0.8f);
+    drawText2D(5.0f, 10.0f, info, GLUT_BITMAP_HELVETICA_12);
+
+    if (!kioskMode) {
+        glColor3f(0.8f, 0.8f, 0.8f);
+        drawText2D(5.0f, 5.0f,
+                   "LEFT/RIGHT: change element  |  Click: select  |  Wheel, +/-: zoom  |  Right-drag: pan  |  "
+                   "Z: zoom to cell  |  0: reset  |  C: colour by property  |  'A': Atom View",
+                   GLUT_BITMAP_HELVETICA_10);
+    }
+
+    char quality[160];
+    formatQualityStatus(quality);
+    glColor3f(0.6f, 0.7f, 0.9f);
+    drawText2D(5.0f, 1.5f, quality, GLUT_BITMAP_HELVETICA_10);
+
+    if (streamEnabled) {
+        char stream[96];
+        formatStreamStatus(stream);
+        drawText2D(68.0f, 1.5f, stream, GLUT_BITMAP_HELVETICA_10);
+    }
+
+    glEnable(GL_LIGHTING);
+}
+
+// Rough neutron/proton ratio: light ~1.0, medium ~1.3, heavy ~1.5
+int neutronCount(int Z) {
+    if (Z == 1) return 0;
+
+    float nOverZ;
+    if (Z <= 20)       nOverZ = 1.0f;
+    else if (Z <= 40)  nOverZ = 1.2f;
+    else if (Z <= 82)  nOverZ = 1.4f;
+    else               nOverZ = 1.5f;
+
+    return (int)(nOverZ * Z);
+}
+
+// LCG in [0,1]; replaces srand/rand whose state is global
+float layoutRandom(unsigned int& state) {
+    state = state * LAYOUT_LCG_MUL + LAYOUT_LCG_ADD;
+    return (float)(state >> 8) / 16777215.0f;
+}
+
+// Nucleons drawn under a cap, keeping the proton/neutron ratio; returns total
+int nucleonSplit(int Z, int maxNucleons, int& drawProtons) {
+    int neutrons = neutronCount(Z);
+    int totalNucleons = Z + neutrons;
+
+    if (maxNucleons > MAX_NUCLEONS) maxNucleons = MAX_NUCLEONS;
+
+    drawProtons = Z;
+    if (totalNucleons <= maxNucleons) return totalNucleons;
+
+    float factor = (float)maxNucleons / (float)totalNucleons;
+    drawProtons = (int)(Z * factor);
+    return maxNucleons;
+}
+
+// Place up to maxNucleons protons then neutrons in a sphere; returns count
+int buildNucleusLayout(const ElementInfo& e, int maxNucleons, Nucleon* out) {
+    int Z = e.Z;
+    int drawProtons;
+    int count = nucleonSplit(Z, maxNucleons, drawProtons);
+
+    float clusterRadius = NUCLEUS_BASE_RADIUS + NUCLEUS_RADIUS_PER_Z * Z;
+
+    // Private generator seeded by Z: same layout every time, safe on worker threads
+    unsigned int seed = (unsigned int)e.Z;
+
+    for (int i = 0; i < count; ++i) {
+        float u = layoutRandom(seed);
+        float v = layoutRandom(seed);
+        float w = layoutRandom(seed);
+
+        float theta = 2.0f * PI * u;
+        float phi   = acosf(2.0f * v - 1.0f);
+        float r     = cbrtf(w);  // cube root for uniform distribution in volume
+
+        out[i].x = r * sinf(phi) * cosf(theta) * clusterRadius;
+        out[i].y = r * sinf(phi) * sinf(theta) * clusterRadius;
+        out[i].z = r * cosf(phi) * clusterRadius;
+        out[i].proton = i < drawProtons;
+    }
+    return count;
+}
+
+// Fill nucleons[] for e from the scene cache (or build it); returns count
+int prepareNucleus(const ElementInfo& e, int maxNucleons) {
+    if (!sceneNucleusPositions) return buildNucleusLayout(e, maxNucleons, nucleons);
+
+    // Cached positions are cap-independent; only the split changes
+    int drawProtons;
+    int count = nucleonSplit(e.Z, maxNucleons, drawProtons);
+    const float* p = sceneNucleusPositions + (size_t)(e.Z - 1) * MAX_NUCLEONS * 3;
+    for (int i = 0; i < count; ++i) {
+        nucleons[i].x = p[i * 3 + 0];
+        nucleons[i].y = p[i * 3 + 1];
+        nucleons[i].z = p[i * 3 + 2];
+        nucleons[i].proton = i < drawProtons;
+    }
+    return count;
+}
+
+// Nucleus drawing (simple cluster)
+void drawNucleus(const ElementInfo& e) {
+    const QualityLevel &q = qualityLevels[qualityIndex];
+    int count = prepareNucleus(e, q.maxNucleonsDraw);
+
+    float sphereRadius  = 0.4f;
+
+    for (int i = 0; i < count; ++i) {
+        if (nucleons[i].proton)
+            glColor3f(1.0f, 0.2f, 0.2f);   // protons red
+        else
+            glColor3f(0.2f, 0.4f, 1.0f);   // neutrons blue
 
         glPushMatrix();
-        glTranslatef(x, y, z);
-        glutSolidSphere(sphereRadius, 16, 16);
+        glTranslatef(nucleons[i].x, nucleons[i].y, nucleons[i].z);
+        drawSphere(sphereRadius, q.nucleonSlices);
         glPopMatrix();
     }
+}
+
+
+void drawOrbit(const Electron &e) {
+    glDisable(GL_LIGHTING);
+    glColor3f(0.6f, 0.6f, 0.6f);
+    glPushMatrix();
+    glRotatef(e.tiltX, 1.0f, 0.0f, 0.0f);
+    glRotatef(e.tiltY, 0.0f, 1.0f, 0.0f);
+
+    int segments = qualityLevels[qualityIndex].orbitSegments;
+    glBegin(GL_LINE_LOOP);
+    for (int i = 0; i < segments; ++i) {
+        float ang = 2.0f * PI * i / (float)segments;
+        float x = e.radius * cosf(ang);
+        float z = e.radius * sinf(ang);
+        glVertex3f(x, 0.0f, z);
+    }
+    glEnd();
+
+    glPopMatrix();
+    glEnable(GL_LIGHTING);
+}
+
+// One ring per occupied shell. Ring geometry never depends on how many
+// electrons the shell holds, so the list is only recompiled when the
+// quality level changes the segment count
+void drawShellOrbit(int shell) {
+    int segments = qualityLevels[qualityIndex].orbitSegments;
+
+    if (!orbitLists) {
+        orbitLists = glGenLists(NUM_SHELLS);
+        memset(orbitListSegments, 0, sizeof(orbitListSegments));
+    }
+    if (orbitListSegments[shell] != segments) {
+        Electron ring;
+        shellSlotElectron(shell, 0, 1, ring);
+        glNewList(orbitLists + shell, GL_COMPILE);
+        drawOrbit(ring);
+        glEndList();
+        orbitListSegments[shell] = segments;
+    }
+    glCallList(orbitLists + shell);
+}
+
+void drawElectron(const Electron &e) {
+    glColor3f(1.0f, 0.9f, 0.2f); // yellow-ish
+
+    glPushMatrix();
+    glRotatef(e.tiltX, 1.0f, 0.0f, 0.0f);
+    glRotatef(e.tiltY, 0.0f, 1.0f, 0.0f);
+
+    glRotatef(e.angle, 0.0f, 1.0f, 0.0f);
+    glTranslatef(e.radius, 0.0f, 0.0f);
+
+    int slices = qualityLevels[qualityIndex].electronSlices;
+    drawSphere(1.0f, slices);
+    glPopMatrix();
+}
+
+void drawAtomScene() {
+    setCamera3D();
+
+    globalRotation += 0.02f;
+    glRotatef(globalRotation, 0.0f, 1.0f, 0.0f);
+
+    ElementInfo &sel = elements[selectedIndex];
+
+    // Draw nucleus based on this element
+    drawNucleus(sel);
+
+    // Draw orbits & electrons
+    for (int s = 0; s < NUM_SHELLS; ++s) {
+        if (shellCount[s] == 0) continue;
+        drawShellOrbit(s);
+        for (int i = shellFirst[s]; i < shellFirst[s] + shellCount[s]; ++i) {
+            Electron v;
+            electronVisual(i, v);
+            drawElectron(v);
+        }
+    }
+    for (int k = 0; k < numEscaping; ++k) {
+        Electron v = escaping[k].e;
+        v.radius += 30.0f * escaping[k].t * escaping[k].t;
+        drawElectron(v);
+    }
+
+    // ---- 2D overlay using the SAME 'sel' ----
+    glDisable(GL_LIGHTING);
+
+    glMatrixMode(GL_PROJECTION);
+    glPushMatrix();
+    glLoadIdentity();
+    gluOrtho2D(0, 100, 0, 100);
+
+    glMatrixMode(GL_MODELVIEW);
+    glPushMatrix();
+    glLoadIdentity();
+
+    char groupTxt[32];
+    if (sel.group > 0) {
+        sprintf(groupTxt, "%d", sel.group);
+    } else {
+        sprintf(groupTxt, "f-block");
+    }
+
+    char info[256];
+    sprintf(info, "%s (%s), Z = %d, Period = %d, Group = %s",
+            sel.name, sel.symbol, sel.Z, sel.period, groupTxt);
+
+    glColor3f(0.9f, 1.0f, 0.9f);
+    drawText2D(5.0f, 95.0f, info, GLUT_BITMAP_HELVETICA_12);
+
+    if (!kioskMode) {
+        glColor3f(0.8f, 0.8f, 0.8f);
+        drawText2D(5.0f, 90.0f,
+                   "Arrow keys = rotate  |  +/- = zoom  |  SPACE = pause  |  ',' / '.' = remove / add electron  |  "
+                   "'E' = excite  |  'G' = ground state  |  'T' = Table View",
+                   GLUT_BITMAP_HELVETICA_10);
+    }
+
+    char quality[160];
+    formatQualityStatus(quality);
+    glColor3f(0.6f, 0.7f, 0.9f);
+    drawText2D(5.0f, 86.0f, quality, GLUT_BITMAP_HELVETICA_10);
+
+    char ion[128];
+    formatIonStatus(ion);
+    glColor3f(1.0f, 0.9f, 0.5f);
+    drawText2D(5.0f, 82.0f, ion, GLUT_BITMAP_HELVETICA_10);
+
+    if (streamEnabled) {
+        char stream[96];
+        formatStreamStatus(stream);
+        glColor3f(0.6f, 0.7f, 0.9f);
+        drawText2D(5.0f, 78.0f, stream, GLUT_BITMAP_HELVETICA_10);
+    }
+
+    glPopMatrix();
+    glMatrixMode(GL_PROJECTION);
+    glPopMatrix();
+    glMatrixMode(GL_MODELVIEW);
+
+    glEnable(GL_LIGHTING);
+}
+
+
+// --------------------------------------------------------
+// Scene cache: prebuilt meshes, shells, nucleus layouts and
+// table geometry in one memory-mapped file
+// --------------------------------------------------------
+
+// Bump whenever anything that feeds the cache changes shape or meaning
+const unsigned int SCENE_CACHE_VERSION = 2;
+
+// Bump whenever a generator's code changes what it produces (shell tilts and
+// speeds, mesh topology, table placement rules...); the named layout
+// constants are hashed into the settings key and need no bump
+const unsigned int SCENE_GENERATOR_VERSION = 1;
+
+enum SceneSectionId {
+    SCENE_TABLE_CELLS = 1,     // CellRect[cellCount]
+    SCENE_SHELL_INDEX,         // int[numElements + 1], offsets into SCENE_SHELLS
+    SCENE_SHELLS,              // Electron[], ground-state shells for Z = 1..118
+    SCENE_NUCLEUS_POSITIONS,   // float[numElements][MAX_NUCLEONS][3]
+    SCENE_MESH_INDEX,          // SceneMeshEntry[numSphereMeshes]
+    SCENE_MESH_DATA            // unit-sphere vertices (float xyz) and indices (ushort)
+};
+const int SCENE_SECTION_COUNT = SCENE_MESH_DATA;
+
+struct SceneSection {
+    unsigned int id, offset, size, count;
+};
+
+struct SceneCacheHeader {
+    char         magic[8];     // "ATOMSCN"
+    unsigned int version;
+    unsigned int settingsKey;  // must match sceneSettingsKey()
+    unsigned int payloadSize;  // bytes after the header
+    unsigned int checksum;     // FNV-1a over the payload
+    unsigned int sectionCount;
+    SceneSection sections[SCENE_SECTION_COUNT];
+};
+
+struct SceneMeshEntry {
+    int slices, vertexCount, indexCount;
+    unsigned int vertexOffset, indexOffset;   // within SCENE_MESH_DATA
+};
+
+unsigned int fnv1a(const void* data, size_t size, unsigned int h) {
+    const unsigned char* bytes = (const unsigned char*)data;
+    for (size_t i = 0; i < size; ++i) {
+        h = (h ^ bytes[i]) * 16777619u;
+    }
+    return h;
+}
+
+// Everything the generators read: sizes, mesh slices, layout constants and
+// the generator version. Nothing is built here, so validation stays cheap
+unsigned int sceneSettingsKey() {
+    int params[] = { (int)SCENE_GENERATOR_VERSION, numElements, MAX_ELECTRONS, MAX_NUCLEONS,
+                     (int)sizeof(Electron), (int)sizeof(CellRect), numQualityLevels };
+    unsigned int h = fnv1a(params, sizeof(params), 2166136261u);
+    for (int i = 0; i < numQualityLevels; ++i) {
+        h = fnv1a(&qualityLevels[i].nucleonSlices,  sizeof(int), h);
+        h = fnv1a(&qualityLevels[i].electronSlices, sizeof(int), h);
+    }
+
+    float layout[] = { TABLE_START_X, TABLE_CELL_W, TABLE_ROW_H,
+                       TABLE_TOP_Y, TABLE_LANTH_Y, TABLE_ACT_Y,
+                       SHELL_BASE_RADIUS, SHELL_RADIUS_STEP, SHELL_BASE_SPEED,
+                       NUCLEUS_BASE_RADIUS, NUCLEUS_RADIUS_PER_Z };
+    unsigned int lcg[] = { LAYOUT_LCG_MUL, LAYOUT_LCG_ADD };
+    h = fnv1a(layout, sizeof(layout), h);
+    h = fnv1a(lcg, sizeof(lcg), h);
+    h = fnv1a(shellCapacity, sizeof(shellCapacity), h);
+    return h;
+}
+
+// Every slice count any quality level asks for, sorted, no duplicates
+int collectSphereSlices(int* slices) {
+    int n = 0;
+    for (int i = 0; i < numQualityLevels; ++i) {
+        slices[n++] = qualityLevels[i].nucleonSlices;
+        slices[n++] = qualityLevels[i].electronSlices;
+    }
+    std::sort(slices, slices + n);
+    return (int)(std::unique(slices, slices + n) - slices);
+}
+
+// Unit sphere, stacks == slices like the glutSolidSphere calls it replaces
+void buildSphereMesh(int slices, std::vector<float>& vertices, std::vector<unsigned short>& indices) {
+    int stacks = slices;
+    for (int st = 0; st <= stacks; ++st) {
+        float phi = PI * st / stacks;
+        for (int sl = 0; sl <= slices; ++sl) {
+            float theta = 2.0f * PI * sl / slices;
+            vertices.push_back(sinf(phi) * cosf(theta));
+            vertices.push_back(sinf(phi) * sinf(theta));
+            vertices.push_back(cosf(phi));
+        }
+    }
+    for (int st = 0; st < stacks; ++st) {
+        for (int sl = 0; sl < slices; ++sl) {
+            unsigned short a = (unsigned short)(st * (slices + 1) + sl);
+            unsigned short b = (unsigned short)(a + slices + 1);
+            indices.push_back(a);  indices.push_back(b);      indices.push_back(a + 1);
+            indices.push_back(b);  indices.push_back(b + 1);  indices.push_back(a + 1);
+        }
+    }
+}
+
+// Append one section, 16-byte aligned
+void sceneAddSection(std::vector<unsigned char>& payload, SceneCacheHeader& header,
+                     unsigned int id, const void* data, size_t size, int count) {
+    while (payload.size() % 16) payload.push_back(0);
+
+    SceneSection &s = header.sections[header.sectionCount++];
+    s.id     = id;
+    s.offset = (unsigned int)(sizeof(SceneCacheHeader) + payload.size());
+    s.size   = (unsigned int)size;
+    s.count  = (unsigned int)count;
+
+    const unsigned char* bytes = (const unsigned char*)data;
+    payload.insert(payload.end(), bytes, bytes + size);
+}
+
+// Build every section from scratch into one file image
+void buildSceneImage(std::vector<unsigned char>& image) {
+    SceneCacheHeader header;
+    memset(&header, 0, sizeof(header));
+    std::vector<unsigned char> payload;
+
+    layoutPeriodicTable();
+    sceneAddSection(payload, header, SCENE_TABLE_CELLS, cellRects,
+                    cellCount * sizeof(CellRect), cellCount);
+
+    std::vector<int> shellIndex(numElements + 1, 0);
+    std::vector<Electron> shells;
+    Electron scratch[MAX_ELECTRONS];
+    for (int i = 0; i < numElements; ++i) {
+        int n = buildElectronShells(elements[i], scratch);
+        shellIndex[i + 1] = shellIndex[i] + n;
+        shells.insert(shells.end(), scratch, scratch + n);
+    }
+    sceneAddSection(payload, header, SCENE_SHELL_INDEX, shellIndex.data(),
+                    shellIndex.size() * sizeof(int), numElements + 1);
+    sceneAddSection(payload, header, SCENE_SHELLS, shells.data(),
+                    shells.size() * sizeof(Electron), (int)shells.size());
+
+    // Positions do not depend on the cap, only the proton/neutron split does
+    std::vector<float> positions((size_t)numElements * MAX_NUCLEONS * 3, 0.0f);
+    Nucleon cluster[MAX_NUCLEONS];
+    for (int i = 0; i < numElements; ++i) {
+        int count = buildNucleusLayout(elements[i], MAX_NUCLEONS, cluster);
+        float* dst = &positions[(size_t)i * MAX_NUCLEONS * 3];
+        for (int k = 0; k < count; ++k) {
+            dst[k * 3 + 0] = cluster[k].x;
+            dst[k * 3 + 1] = cluster[k].y;
+            dst[k * 3 + 2] = cluster[k].z;
+        }
+    }
+    sceneAddSection(payload, header, SCENE_NUCLEUS_POSITIONS, positions.data(),
+                    positions.size() * sizeof(float), numElements);
+
+    int slices[2 * MAX_SPHERE_MESHES];
+    int meshCount = std::min(collectSphereSlices(slices), MAX_SPHERE_MESHES);
+    SceneMeshEntry entries[MAX_SPHERE_MESHES];
+    std::vector<unsigned char> meshData;
+    for (int m = 0; m < meshCount; ++m) {
+        std::vector<float> v;
+        std::vector<unsigned short> idx;
+        buildSphereMesh(slices[m], v, idx);
+
+        entries[m].slices       = slices[m];
+        entries[m].vertexCount  = (int)v.size() / 3;
+        entries[m].indexCount   = (int)idx.size();
+        entries[m].vertexOffset = (unsigned int)meshData.size();
+        meshData.insert(meshData.end(), (unsigned char*)v.data(),
+                        (unsigned char*)(v.data() + v.size()));
+        while (meshData.size() % 4) meshData.push_back(0);
+        entries[m].indexOffset = (unsigned int)meshData.size();
+        meshData.insert(meshData.end(), (unsigned char*)idx.data(),
+                        (unsigned char*)(idx.data() + idx.size()));
+        while (meshData.size() % 4) meshData.push_back(0);
+    }
+    sceneAddSection(payload, header, SCENE_MESH_INDEX, entries,
+                    meshCount * sizeof(SceneMeshEntry), meshCount);
+    sceneAddSection(payload, header, SCENE_MESH_DATA, meshData.data(), meshData.size(), 0);
+
+    memcpy(header.magic, "ATOMSCN", 8);
+    header.version     = SCENE_CACHE_VERSION;
+    header.settingsKey = sceneSettingsKey();
+    header.payloadSize = (unsigned int)payload.size();
+    header.checksum    = fnv1a(payload.data(), payload.size(), 2166136261u);
+
+    image.resize(sizeof(header) + payload.size());
+    memcpy(image.data(), &header, sizeof(header));
+    memcpy(image.data() + sizeof(header), payload.data(), payload.size());
+}
+
+const SceneSection* sceneFindSection(const SceneCacheHeader* header, unsigned int id) {
+    for (unsigned int i = 0; i < header->sectionCount; ++i) {
+        if (header->sections[i].id == id) return &header->sections[i];
+    }
+    return 0;
+}
+
+// Point the runtime tables into a validated image; false if anything is off
+bool bindSceneImage(const unsigned char* image, size_t size) {
+    if (size < sizeof(SceneCacheHeader)) return false;
+    const SceneCacheHeader* header = (const SceneCacheHeader*)image;
+
+    if (memcmp(header->magic, "ATOMSCN", 8) != 0 ||
+        header->version != SCENE_CACHE_VERSION ||
+        header->settingsKey != sceneSettingsKey() ||
+        header->sectionCount > SCENE_SECTION_COUNT ||
+        sizeof(SceneCacheHeader) + header->payloadSize != size)
+        return false;
+
+    if (fnv1a(image + sizeof(SceneCacheHeader), header->payloadSize, 2166136261u) != header->checksum)
+        return false;
+
+    // Every section inside the file (written so offset + size cannot wrap)
+    // and 4-byte aligned for the float / int views below
+    const SceneSection* sec[SCENE_SECTION_COUNT + 1];
+    for (int id = SCENE_TABLE_CELLS; id <= SCENE_MESH_DATA; ++id) {
+        sec[id] = sceneFindSection(header, id);
+        if (!sec[id] || sec[id]->offset > size || sec[id]->size > size - sec[id]->offset ||
+            sec[id]->offset % 4 != 0)
+            return false;
+    }
+
+    // Counts and sizes must be exactly what the readers below assume
+    const SceneSection &cells = *sec[SCENE_TABLE_CELLS];
+    const SceneSection &index = *sec[SCENE_SHELL_INDEX];
+    const SceneSection &shell = *sec[SCENE_SHELLS];
+    const SceneSection &pos   = *sec[SCENE_NUCLEUS_POSITIONS];
+    const SceneSection &mesh  = *sec[SCENE_MESH_INDEX];
+    const SceneSection &data  = *sec[SCENE_MESH_DATA];
+    if (cells.count > sizeof(cellRects) / sizeof(cellRects[0]) ||
+        cells.size  != cells.count * sizeof(CellRect) ||
+        index.count != (unsigned int)numElements + 1 ||
+        index.size  != index.count * sizeof(int) ||
+        shell.size  != shell.count * sizeof(Electron) ||
+        pos.count   != (unsigned int)numElements ||
+        pos.size    != (size_t)numElements * MAX_NUCLEONS * 3 * sizeof(float) ||
+        mesh.count  > (unsigned int)MAX_SPHERE_MESHES ||
+        mesh.size   != mesh.count * sizeof(SceneMeshEntry))
+        return false;
+
+    // Shell offsets: ascending, within SCENE_SHELLS, at most MAX_ELECTRONS each
+    const int* shellIndex = (const int*)(image + index.offset);
+    if (shellIndex[0] != 0 || shellIndex[numElements] != (int)shell.count) return false;
+    for (int i = 0; i < numElements; ++i) {
+        int n = shellIndex[i + 1] - shellIndex[i];
+        if (n < 0 || n > MAX_ELECTRONS) return false;
+    }
+
+    // Mesh ranges inside SCENE_MESH_DATA, indices inside their vertex range
+    const SceneMeshEntry* entries = (const SceneMeshEntry*)(image + mesh.offset);
+    const unsigned char* meshData = image + data.offset;
+    for (unsigned int m = 0; m < mesh.count; ++m) {
+        const SceneMeshEntry &e = entries[m];
+        if (e.vertexCount < 0 || e.indexCount < 0 ||
+            e.vertexOffset % 4 != 0 || e.indexOffset % 2 != 0 ||
+            e.vertexOffset > data.size || (size_t)e.vertexCount * 3 * sizeof(float) > data.size - e.vertexOffset ||
+            e.indexOffset  > data.size || (size_t)e.indexCount * sizeof(unsigned short) > data.size - e.indexOffset)
+            return false;
+        const unsigned short* idx = (const unsigned short*)(meshData + e.indexOffset);
+        for (int k = 0; k < e.indexCount; ++k) {
+            if (idx[k] >= e.vertexCount) return false;
+        }
+    }
+
+    // Table geometry is tiny and mutable state elsewhere, so copy it out
+    cellCount = (int)sec[SCENE_TABLE_CELLS]->count;
+    memcpy(cellRects, image + sec[SCENE_TABLE_CELLS]->offset, cellCount * sizeof(CellRect));
+
+    sceneShellIndex       = shellIndex;
+    sceneShells           = (const Electron*)(image + shell.offset);
+    sceneNucleusPositions = (const float*)   (image + pos.offset);
+
+    numSphereMeshes = (int)mesh.count;
+    for (int m = 0; m < numSphereMeshes; ++m) {
+        sphereMeshes[m].slices      = entries[m].slices;
+        sphereMeshes[m].vertexCount = entries[m].vertexCount;
+        sphereMeshes[m].indexCount  = entries[m].indexCount;
+        sphereMeshes[m].vertices    = (const float*)(meshData + entries[m].vertexOffset);
+        sphereMeshes[m].indices     = (const unsigned short*)(meshData + entries[m].indexOffset);
+    }
+    return true;
+}
+
+// Back to the generators, as with --no-scene-cache; the table cells were
+// copied out and stay valid
+void unbindSceneImage() {
+    sceneShellIndex       = 0;
+    sceneShells           = 0;
+    sceneNucleusPositions = 0;
+    numSphereMeshes       = 0;
+}
+
+// Read-only view of a whole file, or 0
+const unsigned char* mapCacheFile(const char* path, size_t& size) {
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, 0, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL, 0);
+    if (file == INVALID_HANDLE_VALUE) return 0;
+    LARGE_INTEGER len;
+    if (!GetFileSizeEx(file, &len) || len.QuadPart == 0) { CloseHandle(file); return 0; }
+    HANDLE mapping = CreateFileMappingA(file, 0, PAGE_READONLY, 0, 0, 0);
+    CloseHandle(file);
+    if (!mapping) return 0;
+    void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(mapping);   // the view keeps the mapping alive
+    size = (size_t)len.QuadPart;
+    return (const unsigned char*)view;
+#else
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return 0;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0) { close(fd); return 0; }
+    void* view = mmap(0, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);              // the mapping keeps the file alive
+    if (view == MAP_FAILED) return 0;
+    size = (size_t)st.st_size;
+    return (const unsigned char*)view;
+#endif
+}
+
+void unmapCacheFile(const unsigned char* view, size_t size) {
+#ifdef _WIN32
+    UnmapViewOfFile(view);
+#else
+    munmap((void*)view, size);
+#endif
+}
+
+// Map the cache if it is current, otherwise rebuild it and write a fresh file
+void loadSceneCache(bool useFile) {
+    if (useFile) {
+        size_t size = 0;
+        const unsigned char* view = mapCacheFile(SCENE_CACHE_FILE, size);
+        if (view && bindSceneImage(view, size)) {
+            sceneMapped     = view;
+            sceneMappedSize = size;
+            sceneCacheStatus = "hit";
+            return;
+        }
+        if (view) unmapCacheFile(view, size);
+    }
+
+    buildSceneImage(sceneBuilt);
+    bindSceneImage(sceneBuilt.data(), sceneBuilt.size());
+    sceneCacheStatus = useFile ? "rebuilt" : "disabled";
+    if (!useFile) return;
+
+    // Write beside, then rename, so a crash never leaves a torn cache
+    char tmpPath[256];
+    sprintf(tmpPath, "%s.tmp", SCENE_CACHE_FILE);
+    FILE* f = fopen(tmpPath, "wb");
+    if (!f) return;
+    bool ok = fwrite(sceneBuilt.data(), 1, sceneBuilt.size(), f) == sceneBuilt.size();
+    ok = (fclose(f) == 0) && ok;
+    remove(SCENE_CACHE_FILE);
+    if (!ok || rename(tmpPath, SCENE_CACHE_FILE) != 0) remove(tmpPath);
+}
+
+const SphereMesh* findSphereMesh(int slices) {
+    for (int m = 0; m < numSphereMeshes; ++m) {
+        if (sphereMeshes[m].slices == slices) return &sphereMeshes[m];
+    }
+    return 0;
+}
+
+// Cached mesh when available, GLUT tessellation otherwise
+void drawSphere(float radius, int slices) {
+    const SphereMesh* mesh = findSphereMesh(slices);
+    if (!mesh) {
+        glutSolidSphere(radius, slices, slices);
+        return;
+    }
+
+    glPushMatrix();
+    glScalef(radius, radius, radius);   // GL_NORMALIZE fixes the normals
+    glEnableClientState(GL_VERTEX_ARRAY);
+    glEnableClientState(GL_NORMAL_ARRAY);
+    glVertexPointer(3, GL_FLOAT, 0, mesh->vertices);
+    glNormalPointer(GL_FLOAT, 0, mesh->vertices);   // unit sphere: normal == position
+    glDrawElements(GL_TRIANGLES, mesh->indexCount, GL_UNSIGNED_SHORT, mesh->indices);
+    glDisableClientState(GL_NORMAL_ARRAY);
+    glDisableClientState(GL_VERTEX_ARRAY);
+    glPopMatrix();
+}
+
+// --------------------------------------------------------
+// Atom thumbnails: software-rendered on worker threads,
+// uploaded into one atlas texture on the GL thread
+// --------------------------------------------------------
+
+// Anything that changes thumbnail pixels must change this key. Rendering
+// a few probe atoms covers the real inputs (shell radii and tilts, nucleus
+// layout, colours, view transform) without listing them by hand
+unsigned int thumbSettingsKey() {
+    const unsigned int THUMB_RENDER_VERSION = 1;
+    unsigned int parts[] = { THUMB_RENDER_VERSION, (unsigned int)THUMB_SIZE,
+                             (unsigned int)THUMB_NUCLEONS, (unsigned int)numElements };
+    unsigned int h = fnv1a(parts, sizeof(parts), 2166136261u);
+
+    // H, Fe and Og: one to seven shells, small to capped nuclei
+    const int probes[] = { 1, 26, 118 };
+    static unsigned char tile[THUMB_SIZE * THUMB_SIZE * 4];
+    static std::mutex probeMutex;     // load (GL thread) and save (worker) may overlap
+    std::lock_guard<std::mutex> lock(probeMutex);
+    for (int k = 0; k < 3; ++k) {
+        if (probes[k] > numElements) continue;
+        renderAtomThumbnail(elements[probes[k] - 1], tile);
+        h = fnv1a(tile, sizeof(tile), h);
+    }
+    return h;
+}
+
+struct ThumbSprite {
+    float x, y, depth, radius;      // screen px, view depth, px
+    float r, g, b;
+};
+
+// View rotation matching the default camera (camAngleY = 30, camAngleX = 20)
+void thumbViewTransform(float& x, float& y, float& z) {
+    const float cy = cosf(-30.0f * PI / 180.0f), sy = sinf(-30.0f * PI / 180.0f);
+    const float cx = cosf( 20.0f * PI / 180.0f), sx = sinf( 20.0f * PI / 180.0f);
+
+    float x1 =  cy * x + sy * z;
+    float z1 = -sy * x + cy * z;
+    float y2 =  cx * y - sx * z1;
+    float z2 =  sx * y + cx * z1;
+    x = x1; y = y2; z = z2;
+}
+
+// Blend a colour over one pixel
+void thumbBlend(unsigned char* rgba, int px, int py, float r, float g, float b, float a) {
+    if (px < 0 || py < 0 || px >= THUMB_SIZE || py >= THUMB_SIZE) return;
+    unsigned char* p = rgba + (py * THUMB_SIZE + px) * 4;
+    float da = p[3] / 255.0f;
+    float oa = a + da * (1.0f - a);
+    if (oa <= 0.0f) return;
+    p[0] = (unsigned char)((r * 255.0f * a + p[0] * da * (1.0f - a)) / oa);
+    p[1] = (unsigned char)((g * 255.0f * a + p[1] * da * (1.0f - a)) / oa);
+    p[2] = (unsigned char)((b * 255.0f * a + p[2] * da * (1.0f - a)) / oa);
+    p[3] = (unsigned char)(oa * 255.0f);
+}
+
+// Small CPU render of the atom (no GL, safe on any thread)
+void renderAtomThumbnail(const ElementInfo& e, unsigned char* rgba) {
+    Electron shellElectrons[MAX_ELECTRONS];
+    Nucleon  cluster[MAX_NUCLEONS];
+    ThumbSprite sprites[MAX_ELECTRONS + MAX_NUCLEONS];
+
+    int ne = buildElectronShells(e, shellElectrons);
+    int nn = buildNucleusLayout(e, THUMB_NUCLEONS, cluster);
+
+    memset(rgba, 0, THUMB_SIZE * THUMB_SIZE * 4);
+
+    float outer = (ne > 0) ? shellElectrons[ne - 1].radius : 6.0f;
+    float scale = (THUMB_SIZE * 0.5f - 1.0f) / (outer + 1.0f);
+    float half  = THUMB_SIZE * 0.5f;
+
+    // Orbit rings, one per shell
+    for (int i = 0; i < ne; ++i) {
+        const Electron &el = shellElectrons[i];
+        if (i > 0 && shellElectrons[i - 1].radius == el.radius) continue;
+
+        for (int k = 0; k < 64; ++k) {
+            float ang = 2.0f * PI * k / 64.0f;
+            float x = el.radius * cosf(ang), y = 0.0f, z = el.radius * sinf(ang);
+            // glRotatef(tiltY, 0,1,0) then glRotatef(tiltX, 1,0,0)
+            float ty = el.tiltY * PI / 180.0f, tx = el.tiltX * PI / 180.0f;
+            float x1 = cosf(ty) * x + sinf(ty) * z, z1 = -sinf(ty) * x + cosf(ty) * z;
+            float y2 = cosf(tx) * y - sinf(tx) * z1, z2 = sinf(tx) * y + cosf(tx) * z1;
+            x = x1; y = y2; z = z2;
+            thumbViewTransform(x, y, z);
+            thumbBlend(rgba, (int)(half + x * scale), (int)(half + y * scale),
+                       0.7f, 0.7f, 0.7f, 0.5f);
+        }
+    }
+
+    // Spheres: nucleons then electrons, painted far to near
+    int ns = 0;
+    for (int i = 0; i < nn; ++i) {
+        ThumbSprite &sp = sprites[ns++];
+        float x = cluster[i].x, y = cluster[i].y, z = cluster[i].z;
+        thumbViewTransform(x, y, z);
+        sp.x = half + x * scale;  sp.y = half + y * scale;  sp.depth = z;
+        sp.radius = std::max(0.4f * scale, 1.0f);
+        if (cluster[i].proton) { sp.r = 1.0f; sp.g = 0.2f; sp.b = 0.2f; }
+        else                   { sp.r = 0.2f; sp.g = 0.4f; sp.b = 1.0f; }
+    }
+    for (int i = 0; i < ne; ++i) {
+        const Electron &el = shellElectrons[i];
+        float a  = el.angle * PI / 180.0f;
+        float x = el.radius * cosf(a), y = 0.0f, z = -el.radius * sinf(a);
+        float ty = el.tiltY * PI / 180.0f, tx = el.tiltX * PI / 180.0f;
+        float x1 = cosf(ty) * x + sinf(ty) * z, z1 = -sinf(ty) * x + cosf(ty) * z;
+        float y2 = cosf(tx) * y - sinf(tx) * z1, z2 = sinf(tx) * y + cosf(tx) * z1;
+        x = x1; y = y2; z = z2;
+        thumbViewTransform(x, y, z);
+
+        ThumbSprite &sp = sprites[ns++];
+        sp.x = half + x * scale;  sp.y = half + y * scale;  sp.depth = z;
+        sp.radius = std::max(0.6f * scale, 0.9f);
+        sp.r = 1.0f; sp.g = 0.9f; sp.b = 0.2f;
+    }
+    std::sort(sprites, sprites + ns,
+              [](const ThumbSprite& a, const ThumbSprite& b) { return a.depth < b.depth; });
+
+    for (int i = 0; i < ns; ++i) {
+        const ThumbSprite &sp = sprites[i];
+        int x0 = (int)(sp.x - sp.radius), x1 = (int)(sp.x + sp.radius) + 1;
+        int y0 = (int)(sp.y - sp.radius), y1 = (int)(sp.y + sp.radius) + 1;
+        for (int py = y0; py <= y1; ++py) {
+            for (int px = x0; px <= x1; ++px) {
+                float dx = (px + 0.5f - sp.x) / sp.radius;
+                float dy = (py + 0.5f - sp.y) / sp.radius;
+                float d2 = dx * dx + dy * dy;
+                if (d2 > 1.0f) continue;
+                // Lambert shading from the fake sphere normal, light upper-left
+                float nz = sqrtf(1.0f - d2);
+                float shade = 0.35f + 0.65f * std::max(0.0f, -0.4f * dx + 0.4f * dy + 0.8f * nz);
+                thumbBlend(rgba, px, py, sp.r * shade, sp.g * shade, sp.b * shade, 1.0f);
+            }
+        }
+    }
+}
+
+// Fill tiles from disk; true if every element was found
+bool loadThumbnailCache() {
+    FILE* f = fopen(THUMB_CACHE_FILE, "rb");
+    if (!f) return false;
+
+    char magic[4];
+    unsigned int key = 0;
+    int tileSize = 0, count = 0;
+    bool ok = fread(magic, 1, 4, f) == 4 && memcmp(magic, "ATHB", 4) == 0 &&
+              fread(&key, sizeof(key), 1, f) == 1 && key == thumbSettingsKey() &&
+              fread(&tileSize, sizeof(tileSize), 1, f) == 1 && tileSize == THUMB_SIZE &&
+              fread(&count, sizeof(count), 1, f) == 1 && count <= numElements;
+
+    int loaded = 0;
+    for (int i = 0; ok && i < count; ++i) {
+        int Z = 0;
+        static unsigned char tile[THUMB_SIZE * THUMB_SIZE * 4];
+        if (fread(&Z, sizeof(Z), 1, f) != 1 || fread(tile, sizeof(tile), 1, f) != 1) break;
+        if (Z < 1 || Z > numElements || elements[Z - 1].Z != Z) continue;
+
+        memcpy(thumbPixels[Z - 1], tile, sizeof(tile));
+        thumbState[Z - 1] = THUMB_READY;
+        thumbReadyQueue[thumbReadyCount++] = Z - 1;
+        loaded++;
+    }
+    fclose(f);
+
+    printf("[thumbs] cache %s: %d/%d tiles\n", ok ? "hit" : "stale", loaded, numElements);
+    fflush(stdout);
+    return loaded == numElements;
+}
+
+// Called by the worker that finishes the last tile (caller holds no lock)
+void saveThumbnailCache() {
+    FILE* f = fopen(THUMB_CACHE_FILE, "wb");
+    if (!f) {
+        printf("[thumbs] cannot save %s: %s (tiles will be rendered again next start)\n",
+               THUMB_CACHE_FILE, strerror(errno));
+        fflush(stdout);
+        return;
+    }
+
+    unsigned int key = thumbSettingsKey();
+    int tileSize = THUMB_SIZE, count = numElements;
+    fwrite("ATHB", 1, 4, f);
+    fwrite(&key, sizeof(key), 1, f);
+    fwrite(&tileSize, sizeof(tileSize), 1, f);
+    fwrite(&count, sizeof(count), 1, f);
+    for (int i = 0; i < numElements; ++i) {
+        fwrite(&elements[i].Z, sizeof(int), 1, f);
+        fwrite(thumbPixels[i], sizeof(thumbPixels[i]), 1, f);
+    }
+    bool ok = !ferror(f);
+    if (fclose(f) != 0) ok = false;
+
+    printf("[thumbs] %s %s\n", ok ? "saved" : "failed to write", THUMB_CACHE_FILE);
+    fflush(stdout);
+}
+
+// Lower is more urgent: distance to the cursor or to the selected cell
+float thumbPriority(const CellRect& c) {
+    float cx = c.x + c.w * 0.5f, cy = c.y + c.h * 0.5f;
+
+    const CellRect &sel = cellRects[thumbSelected];   // one cell per element, in order
+    float dx = cx - (sel.x + sel.w * 0.5f), dy = cy - (sel.y + sel.h * 0.5f);
+    float best = dx * dx + dy * dy;
+
+    if (thumbFocusX >= 0.0f) {
+        dx = cx - thumbFocusX;  dy = cy - thumbFocusY;
+        best = std::min(best, dx * dx + dy * dy);
+    }
+    return best;
+}
+
+void thumbWorkerLoop() {
+    static unsigned char tile[MAX_THUMB_WORKERS][THUMB_SIZE * THUMB_SIZE * 4];
+    static int nextSlot = 0;
+
+    std::unique_lock<std::mutex> lock(thumbMutex);
+    unsigned char* scratch = tile[nextSlot++];
+
+    while (!thumbStop) {
+        // Most urgent pending cell, re-evaluated on every pick
+        int job = -1;
+        float bestScore = 0.0f;
+        for (int c = 0; c < cellCount; ++c) {
+            int i = cellRects[c].elementIndex;
+            if (thumbState[i] != THUMB_PENDING) continue;
+            float score = thumbPriority(cellRects[c]);
+            if (job < 0 || score < bestScore) { job = i; bestScore = score; }
+        }
+        if (job < 0) {
+            thumbWake.wait(lock);
+            continue;
+        }
+
+        thumbState[job] = THUMB_RUNNING;
+        lock.unlock();
+        renderAtomThumbnail(elements[job], scratch);
+        lock.lock();
+
+        memcpy(thumbPixels[job], scratch, sizeof(thumbPixels[job]));
+        thumbState[job] = THUMB_READY;
+        thumbReadyQueue[thumbReadyCount++] = job;
+
+        if (++thumbsRendered == numElements) {
+            lock.unlock();
+            saveThumbnailCache();
+            printf("[thumbs] rendered %d tiles, cache written\n", numElements);
+            fflush(stdout);
+            lock.lock();
+        }
+    }
+}
+
+void startThumbnailJobs() {
+    for (int i = 0; i < numElements; ++i) thumbState[i] = THUMB_PENDING;
+    if (loadThumbnailCache()) return;   // warm start: nothing to render
+
+    // Only re-render what the cache did not provide
+    for (int i = 0; i < numElements; ++i) {
+        if (thumbState[i] == THUMB_READY) thumbsRendered++;
+    }
+
+    int cores = (int)std::thread::hardware_concurrency();
+    numThumbWorkers = std::min(std::max(cores - 1, 1), MAX_THUMB_WORKERS);
+    for (int i = 0; i < numThumbWorkers; ++i) {
+        thumbWorkers[i] = std::thread(thumbWorkerLoop);
+    }
+    atexit(stopThumbnailJobs);
+}
+
+void stopThumbnailJobs() {
+    {
+        std::lock_guard<std::mutex> lock(thumbMutex);
+        thumbStop = true;
+    }
+    thumbWake.notify_all();
+    for (int i = 0; i < numThumbWorkers; ++i) {
+        if (thumbWorkers[i].joinable()) thumbWorkers[i].join();
+    }
+}
+
+// Cursor moved in table space: re-rank pending work
+void setThumbnailFocus(float fx, float fy) {
+    {
+        std::lock_guard<std::mutex> lock(thumbMutex);
+        thumbFocusX = fx;
+        thumbFocusY = fy;
+    }
+    thumbWake.notify_all();
+}
+
+// GL thread: copy a few finished tiles into the atlas each frame
+void uploadReadyThumbnails() {
+    int batch[THUMB_UPLOADS_PER_FRAME];
+    int n = 0;
+    bool reprioritise = false;
+    {
+        std::lock_guard<std::mutex> lock(thumbMutex);
+        if (thumbSelected != selectedIndex) {
+            thumbSelected = selectedIndex;
+            reprioritise = true;
+        }
+        while (n < THUMB_UPLOADS_PER_FRAME && thumbReadyCount > 0) {
+            batch[n++] = thumbReadyQueue[0];
+            thumbReadyCount--;
+            memmove(thumbReadyQueue, thumbReadyQueue + 1, thumbReadyCount * sizeof(int));
+        }
+    }
+    if (reprioritise) thumbWake.notify_all();
+    if (n == 0) return;
+
+    glBindTexture(GL_TEXTURE_2D, thumbAtlasTex);
+    for (int k = 0; k < n; ++k) {
+        int i = batch[k];
+        glTexSubImage2D(GL_TEXTURE_2D, 0,
+                        (i % THUMB_ATLAS_COLS) * THUMB_SIZE, (i / THUMB_ATLAS_COLS) * THUMB_SIZE,
+                        THUMB_SIZE, THUMB_SIZE, GL_RGBA, GL_UNSIGNED_BYTE, thumbPixels[i]);
+        thumbInAtlas[i] = true;
+    }
+    glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+// --------------------------------------------------------
+// Frame streaming (--stream): baseline JPEG encoder,
+// one encoder thread, one thread per viewer
+// --------------------------------------------------------
+
+// Natural (row-major) index -> zigzag position
+const unsigned char jpegZigZag[64] = {
+     0,  1,  5,  6, 14, 15, 27, 28,   2,  4,  7, 13, 16, 26, 29, 42,
+     3,  8, 12, 17, 25, 30, 41, 43,   9, 11, 18, 24, 31, 40, 44, 53,
+    10, 19, 23, 32, 39, 45, 52, 54,  20, 22, 33, 38, 46, 51, 55, 60,
+    21, 34, 37, 47, 50, 56, 59, 61,  35, 36, 48, 49, 57, 58, 62, 63
+};
+
+// Standard quantisation tables (ITU T.81 Annex K), natural order
+const unsigned char jpegLumaQuant[64] = {
+    16, 11, 10, 16,  24,  40,  51,  61,  12, 12, 14, 19,  26,  58,  60,  55,
+    14, 13, 16, 24,  40,  57,  69,  56,  14, 17, 22, 29,  51,  87,  80,  62,
+    18, 22, 37, 56,  68, 109, 103,  77,  24, 35, 55, 64,  81, 104, 113,  92,
+    49, 64, 78, 87, 103, 121, 120, 101,  72, 92, 95, 98, 112, 100, 103,  99
+};
+const unsigned char jpegChromaQuant[64] = {
+    17, 18, 24, 47, 99, 99, 99, 99,  18, 21, 26, 66, 99, 99, 99, 99,
+    24, 26, 56, 99, 99, 99, 99, 99,  47, 66, 99, 99, 99, 99, 99, 99,
+    99, 99, 99, 99, 99, 99, 99, 99,  99, 99, 99, 99, 99, 99, 99, 99,
+    99, 99, 99, 99, 99, 99, 99, 99,  99, 99, 99, 99, 99, 99, 99, 99
+};
+
+// Standard Huffman tables (Annex K.3): code counts per length, then symbols
+const unsigned char jpegDcLumaBits[16]   = { 0, 1, 5, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0 };
+const unsigned char jpegDcChromaBits[16] = { 0, 3, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0 };
+const unsigned char jpegDcValues[12]     = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11 };
+
+const unsigned char jpegAcLumaBits[16] = { 0, 2, 1, 3, 3, 2, 4, 3, 5, 5, 4, 4, 0, 0, 1, 0x7d };
+const unsigned char jpegAcLumaValues[162] = {
+    0x01,0x02,0x03,0x00,0x04,0x11,0x05,0x12,0x21,0x31,0x41,0x06,0x13,0x51,0x61,0x07,
+    0x22,0x71,0x14,0x32,0x81,0x91,0xa1,0x08,0x23,0x42,0xb1,0xc1,0x15,0x52,0xd1,0xf0,
+    0x24,0x33,0x62,0x72,0x82,0x09,0x0a,0x16,0x17,0x18,0x19,0x1a,0x25,0x26,0x27,0x28,
+    0x29,0x2a,0x34,0x35,0x36,0x37,0x38,0x39,0x3a,0x43,0x44,0x45,0x46,0x47,0x48,0x49,
+    0x4a,0x53,0x54,0x55,0x56,0x57,0x58,0x59,0x5a,0x63,0x64,0x65,0x66,0x67,0x68,0x69,
+    0x6a,0x73,0x74,0x75,0x76,0x77,0x78,0x79,0x7a,0x83,0x84,0x85,0x86,0x87,0x88,0x89,
+    0x8a,0x92,0x93,0x94,0x95,0x96,0x97,0x98,0x99,0x9a,0xa2,0xa3,0xa4,0xa5,0xa6,0xa7,
+    0xa8,0xa9,0xaa,0xb2,0xb3,0xb4,0xb5,0xb6,0xb7,0xb8,0xb9,0xba,0xc2,0xc3,0xc4,0xc5,
+    0xc6,0xc7,0xc8,0xc9,0xca,0xd2,0xd3,0xd4,0xd5,0xd6,0xd7,0xd8,0xd9,0xda,0xe1,0xe2,
+    0xe3,0xe4,0xe5,0xe6,0xe7,0xe8,0xe9,0xea,0xf1,0xf2,0xf3,0xf4,0xf5,0xf6,0xf7,0xf8,
+    0xf9,0xfa
+};
+const unsigned char jpegAcChromaBits[16] = { 0, 2, 1, 2, 4, 4, 3, 4, 7, 5, 4, 4, 0, 1, 2, 0x77 };
+const unsigned char jpegAcChromaValues[162] = {
+    0x00,0x01,0x02,0x03,0x11,0x04,0x05,0x21,0x31,0x06,0x12,0x41,0x51,0x07,0x61,0x71,
+    0x13,0x22,0x32,0x81,0x08,0x14,0x42,0x91,0xa1,0xb1,0xc1,0x09,0x23,0x33,0x52,0xf0,
+    0x15,0x62,0x72,0xd1,0x0a,0x16,0x24,0x34,0xe1,0x25,0xf1,0x17,0x18,0x19,0x1a,0x26,
+    0x27,0x28,0x29,0x2a,0x35,0x36,0x37,0x38,0x39,0x3a,0x43,0x44,0x45,0x46,0x47,0x48,
+    0x49,0x4a,0x53,0x54,0x55,0x56,0x57,0x58,0x59,0x5a,0x63,0x64,0x65,0x66,0x67,0x68,
+    0x69,0x6a,0x73,0x74,0x75,0x76,0x77,0x78,0x79,0x7a,0x82,0x83,0x84,0x85,0x86,0x87,
+    0x88,0x89,0x8a,0x92,0x93,0x94,0x95,0x96,0x97,0x98,0x99,0x9a,0xa2,0xa3,0xa4,0xa5,
+    0xa6,0xa7,0xa8,0xa9,0xaa,0xb2,0xb3,0xb4,0xb5,0xb6,0xb7,0xb8,0xb9,0xba,0xc2,0xc3,
+    0xc4,0xc5,0xc6,0xc7,0xc8,0xc9,0xca,0xd2,0xd3,0xd4,0xd5,0xd6,0xd7,0xd8,0xd9,0xda,
+    0xe2,0xe3,0xe4,0xe5,0xe6,0xe7,0xe8,0xe9,0xea,0xf2,0xf3,0xf4,0xf5,0xf6,0xf7,0xf8,
+    0xf9,0xfa
+};
+
+struct JpegHuffman {
+    unsigned short code[256];
+    unsigned char  length[256];
+};
+
+struct JpegWriter {
+    std::vector<unsigned char>* out;
+    unsigned int bitBuffer;
+    int          bitCount;
+};
+
+// Canonical codes from the (bits, values) description
+void jpegBuildHuffman(JpegHuffman& h, const unsigned char* bits, const unsigned char* values) {
+    memset(&h, 0, sizeof(h));
+    int code = 0, k = 0;
+    for (int len = 1; len <= 16; ++len) {
+        for (int i = 0; i < bits[len - 1]; ++i) {
+            h.code[values[k]]   = (unsigned short)code++;
+            h.length[values[k]] = (unsigned char)len;
+            k++;
+        }
+        code <<= 1;
+    }
+}
+
+void jpegPutBits(JpegWriter& w, unsigned int bits, int count) {
+    w.bitBuffer = (w.bitBuffer << count) | (bits & ((1u << count) - 1));
+    w.bitCount += count;
+    while (w.bitCount >= 8) {
+        unsigned char c = (unsigned char)(w.bitBuffer >> (w.bitCount - 8));
+        w.out->push_back(c);
+        if (c == 0xFF) w.out->push_back(0);   // byte stuffing
+        w.bitCount -= 8;
+    }
+}
+
+// Magnitude category and the bits that encode v within it
+void jpegCategory(int v, int& size, unsigned int& bits) {
+    int a = v < 0 ? -v : v;
+    size = 0;
+    while (a) { size++; a >>= 1; }
+    bits = (unsigned int)(v < 0 ? v - 1 : v);
+}
+
+// AAN forward DCT on 8 values with the given stride (scaling folded into quant)
+void jpegFdct8(float* d, int stride) {
+    float d0 = d[0], d1 = d[stride], d2 = d[2 * stride], d3 = d[3 * stride];
+    float d4 = d[4 * stride], d5 = d[5 * stride], d6 = d[6 * stride], d7 = d[7 * stride];
+
+    float tmp0 = d0 + d7, tmp7 = d0 - d7, tmp1 = d1 + d6, tmp6 = d1 - d6;
+    float tmp2 = d2 + d5, tmp5 = d2 - d5, tmp3 = d3 + d4, tmp4 = d3 - d4;
+
+    // Even part
+    float tmp10 = tmp0 + tmp3, tmp13 = tmp0 - tmp3;
+    float tmp11 = tmp1 + tmp2, tmp12 = tmp1 - tmp2;
+    d[0]          = tmp10 + tmp11;
+    d[4 * stride] = tmp10 - tmp11;
+    float z1 = (tmp12 + tmp13) * 0.707106781f;
+    d[2 * stride] = tmp13 + z1;
+    d[6 * stride] = tmp13 - z1;
+
+    // Odd part
+    tmp10 = tmp4 + tmp5;
+    tmp11 = tmp5 + tmp6;
+    tmp12 = tmp6 + tmp7;
+    float z5 = (tmp10 - tmp12) * 0.382683433f;
+    float z2 = tmp10 * 0.541196100f + z5;
+    float z4 = tmp12 * 1.306562965f + z5;
+    float z3 = tmp11 * 0.707106781f;
+    float z11 = tmp7 + z3, z13 = tmp7 - z3;
+    d[5 * stride] = z13 + z2;
+    d[3 * stride] = z13 - z2;
+    d[1 * stride] = z11 + z4;
+    d[7 * stride] = z11 - z4;
+}
+
+// DCT, quantise and Huffman-code one 8x8 block; returns its DC for prediction
+int jpegEncodeBlock(JpegWriter& w, float* block, const float* divisors, int prevDc,
+                    const JpegHuffman& dc, const JpegHuffman& ac) {
+    for (int r = 0; r < 8; ++r) jpegFdct8(block + r * 8, 1);
+    for (int c = 0; c < 8; ++c) jpegFdct8(block + c, 8);
+
+    int coeffs[64];
+    for (int i = 0; i < 64; ++i) {
+        float v = block[i] * divisors[i];
+        coeffs[jpegZigZag[i]] = (int)(v < 0.0f ? ceilf(v - 0.5f) : floorf(v + 0.5f));
+    }
+
+    int size;
+    unsigned int bits;
+    jpegCategory(coeffs[0] - prevDc, size, bits);
+    jpegPutBits(w, dc.code[size], dc.length[size]);
+    if (size) jpegPutBits(w, bits, size);
+
+    int last = 63;
+    while (last > 0 && coeffs[last] == 0) last--;
+
+    int run = 0;
+    for (int i = 1; i <= last; ++i) {
+        if (coeffs[i] == 0) { run++; continue; }
+        while (run >= 16) {
+            jpegPutBits(w, ac.code[0xF0], ac.length[0xF0]);   // ZRL
+            run -= 16;
+        }
+        jpegCategory(coeffs[i], size, bits);
+        int symbol = (run << 4) | size;
+        jpegPutBits(w, ac.code[symbol], ac.length[symbol]);
+        jpegPutBits(w, bits, size);
+        run = 0;
+    }
+    if (last < 63) jpegPutBits(w, ac.code[0x00], ac.length[0x00]);   // EOB
+
+    return coeffs[0];
+}
+
+void jpegMarker(std::vector<unsigned char>& out, unsigned char marker, int length) {
+    out.push_back(0xFF);
+    out.push_back(marker);
+    if (length > 0) {
+        out.push_back((unsigned char)(length >> 8));
+        out.push_back((unsigned char)(length & 0xFF));
+    }
+}
+
+void jpegHuffmanSegment(std::vector<unsigned char>& out, int tableClassId,
+                        const unsigned char* bits, const unsigned char* values, int count) {
+    jpegMarker(out, 0xC4, 2 + 1 + 16 + count);
+    out.push_back((unsigned char)tableClassId);
+    out.insert(out.end(), bits, bits + 16);
+    out.insert(out.end(), values, values + count);
+}
+
+// Baseline 4:2:0 JPEG from packed RGB; rows bottom-up as glReadPixels returns them
+void encodeJPEG(const unsigned char* rgb, int width, int height, int quality,
+                std::vector<unsigned char>& out) {
+    static const float aanScale[8] = {
+        1.0f * 2.828427125f, 1.387039845f * 2.828427125f, 1.306562965f * 2.828427125f,
+        1.175875602f * 2.828427125f, 1.0f * 2.828427125f, 0.785694958f * 2.828427125f,
+        0.541196100f * 2.828427125f, 0.275899379f * 2.828427125f
+    };
+
+    if (quality < 1) quality = 1;
+    if (quality > 100) quality = 100;
+    int scale = quality < 50 ? 5000 / quality : 200 - quality * 2;
+
+    unsigned char lumaQ[64], chromaQ[64];     // zigzag order, as stored in DQT
+    float lumaDiv[64], chromaDiv[64];         // natural order, 1 / (q * AAN scale)
+    for (int i = 0; i < 64; ++i) {
+        int yq = (jpegLumaQuant[i] * scale + 50) / 100;
+        int cq = (jpegChromaQuant[i] * scale + 50) / 100;
+        lumaQ[jpegZigZag[i]]   = (unsigned char)std::min(std::max(yq, 1), 255);
+        chromaQ[jpegZigZag[i]] = (unsigned char)std::min(std::max(cq, 1), 255);
+    }
+    for (int r = 0; r < 8; ++r) {
+        for (int c = 0; c < 8; ++c) {
+            int k = r * 8 + c;
+            lumaDiv[k]   = 1.0f / (lumaQ[jpegZigZag[k]]   * aanScale[r] * aanScale[c]);
+            chromaDiv[k] = 1.0f / (chromaQ[jpegZigZag[k]] * aanScale[r] * aanScale[c]);
+        }
+    }
+
+    static JpegHuffman dcLuma, acLuma, dcChroma, acChroma;
+    static std::once_flag tablesBuilt;
+    std::call_once(tablesBuilt, [] {
+        jpegBuildHuffman(dcLuma,   jpegDcLumaBits,   jpegDcValues);
+        jpegBuildHuffman(acLuma,   jpegAcLumaBits,   jpegAcLumaValues);
+        jpegBuildHuffman(dcChroma, jpegDcChromaBits, jpegDcValues);
+        jpegBuildHuffman(acChroma, jpegAcChromaBits, jpegAcChromaValues);
+    });
+
+    out.clear();
+    out.reserve(width * height / 4);
+
+    // Headers: SOI, JFIF, DQT, SOF0, DHT, SOS
+    jpegMarker(out, 0xD8, 0);
+    static const unsigned char jfif[] = { 'J', 'F', 'I', 'F', 0, 1, 1, 0, 0, 1, 0, 1, 0, 0 };
+    jpegMarker(out, 0xE0, 2 + sizeof(jfif));
+    out.insert(out.end(), jfif, jfif + sizeof(jfif));
+
+    jpegMarker(out, 0xDB, 2 + 2 * 65);
+    out.push_back(0);  out.insert(out.end(), lumaQ,   lumaQ + 64);
+    out.push_back(1);  out.insert(out.end(), chromaQ, chromaQ + 64);
+
+    const unsigned char sof[] = {
+        8, (unsigned char)(height >> 8), (unsigned char)height,
+        (unsigned char)(width >> 8), (unsigned char)width, 3,
+        1, 0x22, 0,   2, 0x11, 1,   3, 0x11, 1
+    };
+    jpegMarker(out, 0xC0, 2 + sizeof(sof));
+    out.insert(out.end(), sof, sof + sizeof(sof));
+
+    jpegHuffmanSegment(out, 0x00, jpegDcLumaBits,   jpegDcValues,       12);
+    jpegHuffmanSegment(out, 0x10, jpegAcLumaBits,   jpegAcLumaValues,   162);
+    jpegHuffmanSegment(out, 0x01, jpegDcChromaBits, jpegDcValues,       12);
+    jpegHuffmanSegment(out, 0x11, jpegAcChromaBits, jpegAcChromaValues, 162);
+
+    const unsigned char sos[] = { 3, 1, 0x00, 2, 0x11, 3, 0x11, 0, 63, 0 };
+    jpegMarker(out, 0xDA, 2 + sizeof(sos));
+    out.insert(out.end(), sos, sos + sizeof(sos));
+
+    JpegWriter w = { &out, 0, 0 };
+    int dcY = 0, dcCb = 0, dcCr = 0;
+
+    for (int my = 0; my < height; my += 16) {
+        for (int mx = 0; mx < width; mx += 16) {
+            float Y[256], Cb[64], Cr[64];
+            memset(Cb, 0, sizeof(Cb));
+            memset(Cr, 0, sizeof(Cr));
+
+            // Colour convert the 16x16 MCU (edges clamped), chroma averaged 2x2
+            for (int y = 0; y < 16; ++y) {
+                int sy = std::min(my + y, height - 1);
+                const unsigned char* row = rgb + (size_t)(height - 1 - sy) * width * 3;
+                for (int x = 0; x < 16; ++x) {
+                    const unsigned char* p = row + std::min(mx + x, width - 1) * 3;
+                    float r = p[0], g = p[1], b = p[2];
+                    Y[y * 16 + x] = 0.299f * r + 0.587f * g + 0.114f * b - 128.0f;
+                    int c = (y >> 1) * 8 + (x >> 1);
+                    Cb[c] += 0.25f * (-0.168736f * r - 0.331264f * g + 0.5f * b);
+                    Cr[c] += 0.25f * ( 0.5f * r - 0.418688f * g - 0.081312f * b);
+                }
+            }
+
+            for (int by = 0; by < 2; ++by) {
+                for (int bx = 0; bx < 2; ++bx) {
+                    float block[64];
+                    for (int y = 0; y < 8; ++y)
+                        for (int x = 0; x < 8; ++x)
+                            block[y * 8 + x] = Y[(by * 8 + y) * 16 + bx * 8 + x];
+                    dcY = jpegEncodeBlock(w, block, lumaDiv, dcY, dcLuma, acLuma);
+                }
+            }
+            dcCb = jpegEncodeBlock(w, Cb, chromaDiv, dcCb, dcChroma, acChroma);
+            dcCr = jpegEncodeBlock(w, Cr, chromaDiv, dcCr, dcChroma, acChroma);
+        }
+    }
+
+    jpegPutBits(w, 0x7F, 7);   // pad the last byte with ones
+    jpegMarker(out, 0xD9, 0);
+}
+
+bool sendAll(SOCKET s, const void* data, size_t len) {
+    const char* p = (const char*)data;
+    while (len > 0) {
+        int n = send(s, p, (int)std::min(len, (size_t)65536), 0);
+        if (n <= 0) return false;   // error, or SO_SNDTIMEO expired on a stalled viewer
+        p   += n;
+        len -= n;
+    }
+    return true;
+}
+
+bool sendText(SOCKET s, const char* text) {
+    return sendAll(s, text, strlen(text));
+}
+
+// Push the newest frame to one viewer until it disconnects or we shut down
+void streamMjpeg(SOCKET s) {
+    if (!sendText(s, "HTTP/1.1 200 OK\r\n"
+                     "Content-Type: multipart/x-mixed-replace; boundary=atomframe\r\n"
+                     "Cache-Control: no-cache\r\n"
+                     "Connection: close\r\n\r\n"))
+        return;
+
+    unsigned long lastSeq = 0;
+    for (;;) {
+        std::shared_ptr<const std::vector<unsigned char> > frame;
+        {
+            std::unique_lock<std::mutex> lock(streamMutex);
+            streamNewFrame.wait_for(lock, std::chrono::milliseconds(500), [&] {
+                return streamStop || streamSeq != lastSeq;
+            });
+            if (streamStop) return;
+            if (streamSeq == lastSeq) continue;
+
+            // Whatever arrived while we were sending is skipped, not queued
+            frame   = streamLatest;
+            lastSeq = streamSeq;
+        }
+
+        char header[128];
+        sprintf(header, "--atomframe\r\nContent-Type: image/jpeg\r\nContent-Length: %d\r\n\r\n",
+                (int)frame->size());
+        if (!sendText(s, header) ||
+            !sendAll(s, frame->data(), frame->size()) ||
+            !sendText(s, "\r\n"))
+            return;
+    }
+}
+
+void streamClientLoop(int slot) {
+    SOCKET s = streamClients[slot].socket;
+
+    // Read the request head (we only need the path). SO_RCVTIMEO bounds each
+    // recv(); the deadline stops a client that trickles bytes forever
+    char request[2048];
+    int  got = 0;
+    double deadline = nowMs() + STREAM_REQUEST_TIMEOUT_MS;
+    while (got < (int)sizeof(request) - 1 && nowMs() < deadline) {
+        int n = recv(s, request + got, sizeof(request) - 1 - got, 0);
+        if (n <= 0) break;
+        got += n;
+        request[got] = '\0';
+        if (strstr(request, "\r\n\r\n")) break;
+    }
+    request[got] = '\0';
+
+    char path[256] = "";
+    sscanf(request, "GET %255s", path);
+
+    if (strcmp(path, "/stream.mjpg") == 0) {
+        // Only now is this a viewer: counted for the cap and for capturing
+        bool accepted;
+        {
+            std::lock_guard<std::mutex> lock(streamMutex);
+            accepted = streamViewers < MAX_STREAM_VIEWERS;
+            if (accepted) streamViewers++;
+        }
+        if (accepted) {
+            streamMjpeg(s);
+            std::lock_guard<std::mutex> lock(streamMutex);
+            streamViewers--;
+        } else {
+            sendText(s, "HTTP/1.1 503 Service Unavailable\r\nConnection: close\r\n\r\n");
+        }
+    }
+    else if (strcmp(path, "/frame.jpg") == 0) {
+        // Frames are only captured on demand; ask for one and wait briefly
+        std::shared_ptr<const std::vector<unsigned char> > frame;
+        {
+            std::unique_lock<std::mutex> lock(streamMutex);
+            unsigned long seq = streamSeq;
+            streamSnapshotWaiters++;
+            streamNewFrame.wait_for(lock, std::chrono::seconds(2), [&] {
+                return streamStop || streamSeq != seq;
+            });
+            streamSnapshotWaiters--;
+            frame = streamLatest;
+        }
+        if (frame) {
+            char header[160];
+            sprintf(header, "HTTP/1.1 200 OK\r\nContent-Type: image/jpeg\r\n"
+                            "Content-Length: %d\r\nConnection: close\r\n\r\n", (int)frame->size());
+            if (sendText(s, header)) sendAll(s, frame->data(), frame->size());
+        } else {
+            sendText(s, "HTTP/1.1 503 Service Unavailable\r\nConnection: close\r\n\r\n");
+        }
+    }
+    else if (strcmp(path, "/") == 0) {
+        const char* page =
+            "<!DOCTYPE html><html><head><title>Atom Visualizer</title></head>"
+            "<body style=\"margin:0;background:#000\">"
+            "<img src=\"/stream.mjpg\" style=\"width:100vw;height:100vh;object-fit:contain\">"
+            "</body></html>";
+        char header[160];
+        sprintf(header, "HTTP/1.1 200 OK\r\nContent-Type: text/html\r\n"
+                        "Content-Length: %d\r\nConnection: close\r\n\r\n", (int)strlen(page));
+        if (sendText(s, header)) sendText(s, page);
+    }
+    else {
+        sendText(s, "HTTP/1.1 404 Not Found\r\nContent-Length: 0\r\nConnection: close\r\n\r\n");
+    }
+
+    // Under the lock so stopFrameStreaming never shuts down a reused socket
+    std::lock_guard<std::mutex> lock(streamMutex);
+    closesocket(s);
+    streamClients[slot].active = false;
+}
+
+void streamServerLoop() {
+    while (!streamStop) {
+        // select() with a timeout so the loop notices shutdown
+        fd_set readable;
+        FD_ZERO(&readable);
+        FD_SET(streamListenSocket, &readable);
+        timeval tv = { 0, 200000 };
+        if (select((int)streamListenSocket + 1, &readable, 0, 0, &tv) <= 0) continue;
+
+        SOCKET client = accept(streamListenSocket, 0, 0);
+        if (client == INVALID_SOCKET) continue;
+
+        // Free slot; its previous thread (if any) has already finished
+        int slot = -1;
+        {
+            std::lock_guard<std::mutex> lock(streamMutex);
+            for (int i = 0; i < MAX_STREAM_CLIENTS && slot < 0; ++i) {
+                if (!streamClients[i].active) slot = i;
+            }
+        }
+        if (slot < 0) {
+            sendText(client, "HTTP/1.1 503 Service Unavailable\r\nConnection: close\r\n\r\n");
+            closesocket(client);
+            continue;
+        }
+        if (streamClients[slot].thread.joinable()) streamClients[slot].thread.join();
+
+        // Bound the time a stalled client can hold its thread in send() / recv()
+#ifdef _WIN32
+        DWORD timeoutMs = 2000;
+        setsockopt(client, SOL_SOCKET, SO_SNDTIMEO, (const char*)&timeoutMs, sizeof(timeoutMs));
+        setsockopt(client, SOL_SOCKET, SO_RCVTIMEO, (const char*)&timeoutMs, sizeof(timeoutMs));
+#else
+        timeval timeout = { 2, 0 };
+        setsockopt(client, SOL_SOCKET, SO_SNDTIMEO, (const char*)&timeout, sizeof(timeout));
+        setsockopt(client, SOL_SOCKET, SO_RCVTIMEO, (const char*)&timeout, sizeof(timeout));
+#endif
+        int one = 1;
+        setsockopt(client, IPPROTO_TCP, TCP_NODELAY, (const char*)&one, sizeof(one));
+
+        {
+            std::lock_guard<std::mutex> lock(streamMutex);
+            streamClients[slot].socket = client;
+            streamClients[slot].active = true;
+        }
+        streamClients[slot].thread = std::thread(streamClientLoop, slot);
+    }
+}
+
+// Encode each captured frame once; every viewer shares the result
+void streamEncoderLoop() {
+    std::vector<unsigned char> raw;
+    std::unique_lock<std::mutex> lock(streamMutex);
+
+    while (!streamStop) {
+        if (!streamRawPending) {
+            streamRawReady.wait(lock);
+            continue;
+        }
+        raw.swap(streamRaw);
+        int w = streamRawWidth, h = streamRawHeight;
+        streamRawPending = false;
+        lock.unlock();
+
+        std::shared_ptr<std::vector<unsigned char> > jpeg(new std::vector<unsigned char>());
+        encodeJPEG(raw.data(), w, h, streamQuality, *jpeg);
+
+        lock.lock();
+        streamLatest = jpeg;
+        streamSeq++;
+        streamNewFrame.notify_all();
+    }
+}
 
-    // --- Draw neutrons (blue) ---
-    glColor3f(0.2f, 0.4f, 1.0f);
-    for (int i = 0; i < drawNeutrons; ++i) {
-        float u = (float)rand() / (float)RAND_MAX;
-        float v = (float)rand() / (float)RAND_MAX;
-        float w = (float)rand() / (float)RAND_MAX;
+bool startFrameStreaming(int port) {
+#ifdef _WIN32
+    WSADATA wsa;
+    if (WSAStartup(MAKEWORD(2, 2), &wsa) != 0) return false;
+#else
+    signal(SIGPIPE, SIG_IGN);   // a viewer closing mid-frame must not kill us
+#endif
 
-        float theta = 2.0f * PI * u;
-        float phi   = acosf(2.0f * v - 1.0f);
-        float r     = cbrtf(w);
+    streamListenSocket = socket(AF_INET, SOCK_STREAM, 0);
+    if (streamListenSocket == INVALID_SOCKET) return false;
 
-        float x = r * sinf(phi) * cosf(theta);
-        float y = r * sinf(phi) * sinf(theta);
-        float z = r * cosf(phi);
+    int one = 1;
+    setsockopt(streamListenSocket, SOL_SOCKET, SO_REUSEADDR, (const char*)&one, sizeof(one));
 
-        x *= clusterRadius;
-        y *= clusterRadius;
-        z *= clusterRadius;
+    sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family      = AF_INET;
+    addr.sin_addr.s_addr = htonl(streamPublic ? INADDR_ANY : INADDR_LOOPBACK);
+    addr.sin_port        = htons((unsigned short)port);
 
-        glPushMatrix();
-        glTranslatef(x, y, z);
-        glutSolidSphere(sphereRadius, 16, 16);
-        glPopMatrix();
+    if (bind(streamListenSocket, (sockaddr*)&addr, sizeof(addr)) != 0 ||
+        listen(streamListenSocket, 16) != 0) {
+        printf("[stream] cannot listen on port %d\n", port);
+        closesocket(streamListenSocket);
+        streamListenSocket = INVALID_SOCKET;
+        return false;
     }
+
+    streamPort    = port;
+    streamEnabled = true;
+    streamEncoderThread = std::thread(streamEncoderLoop);
+    streamServerThread  = std::thread(streamServerLoop);
+    atexit(stopFrameStreaming);
+
+    if (streamPublic)
+        printf("[stream] serving http://<this machine>:%d/ on all interfaces (MJPEG at /stream.mjpg)\n", port);
+    else
+        printf("[stream] serving http://localhost:%d/ (MJPEG at /stream.mjpg; --stream-public to share)\n", port);
+    fflush(stdout);
+    return true;
 }
 
+void stopFrameStreaming() {
+    {
+        std::lock_guard<std::mutex> lock(streamMutex);
+        streamStop = true;
+    }
+    streamRawReady.notify_all();
+    streamNewFrame.notify_all();
+
+    if (streamServerThread.joinable())  streamServerThread.join();
+    if (streamEncoderThread.joinable()) streamEncoderThread.join();
+    closesocket(streamListenSocket);
+
+    // Wake clients blocked in recv()/send(), then wait for every thread
+    {
+        std::lock_guard<std::mutex> lock(streamMutex);
+        for (int i = 0; i < MAX_STREAM_CLIENTS; ++i) {
+            if (streamClients[i].active) shutdown(streamClients[i].socket, SD_BOTH);
+        }
+    }
+    for (int i = 0; i < MAX_STREAM_CLIENTS; ++i) {
+        if (streamClients[i].thread.joinable()) streamClients[i].thread.join();
+    }
+}
 
-void drawOrbit(const Electron &e) {
-    glDisable(GL_LIGHTING);
-    glColor3f(0.6f, 0.6f, 0.6f);
-    glPushMatrix();
-    glRotatef(e.tiltX, 1.0f, 0.0f, 0.0f);
-    glRotatef(e.tiltY, 0.0f, 1.0f, 0.0f);
+// GL thread: read back the finished frame if the encoder is free
+void captureStreamFrame(int w, int h) {
+    double now = nowMs();
+    if (now - streamLastCaptureMs < 1000.0 / streamFps) return;
 
-    glBegin(GL_LINE_LOOP);
-    for (int i = 0; i < 100; ++i) {
-        float ang = 2.0f * PI * i / 100.0f;
-        float x = e.radius * cosf(ang);
-        float z = e.radius * sinf(ang);
-        glVertex3f(x, 0.0f, z);
+    {
+        std::lock_guard<std::mutex> lock(streamMutex);
+        if (streamRawPending) return;                                   // encoder busy
+        if (streamViewers == 0 && streamSnapshotWaiters == 0) return;   // nobody watching
     }
-    glEnd();
+    streamLastCaptureMs = now;
+
+    streamCapture.resize((size_t)w * h * 3);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadBuffer(GL_BACK);
+    glReadPixels(0, 0, w, h, GL_RGB, GL_UNSIGNED_BYTE, streamCapture.data());
+
+    {
+        std::lock_guard<std::mutex> lock(streamMutex);
+        streamCapture.swap(streamRaw);
+        streamRawWidth   = w;
+        streamRawHeight  = h;
+        streamRawPending = true;
+    }
+    streamRawReady.notify_one();
+}
 
-    glPopMatrix();
-    glEnable(GL_LIGHTING);
+void formatStreamStatus(char* buf) {
+    int viewers;
+    {
+        std::lock_guard<std::mutex> lock(streamMutex);
+        viewers = streamViewers;
+    }
+    sprintf(buf, "Streaming: http://%s:%d/  |  viewers: %d",
+            streamPublic ? "<this machine>" : "localhost", streamPort, viewers);
 }
 
-void drawElectron(const Electron &e) {
-    glColor3f(1.0f, 0.9f, 0.2f); // yellow-ish
+// --------------------------------------------------------
+// Scripted timelines: camera paths, kiosk playback, scenarios
+// --------------------------------------------------------
+const char* colorModeKeys[NUM_COLOR_MODES] = {
+    "block", "electronegativity", "radius", "density", "mass"
+};
 
-    glPushMatrix();
-    glRotatef(e.tiltX, 1.0f, 0.0f, 0.0f);
-    glRotatef(e.tiltY, 0.0f, 1.0f, 0.0f);
+void timelineMessage(const char* fmt, ...) {
+    if (!timelineLog) return;
+    va_list args;
+    va_start(args, fmt);
+    vfprintf(timelineLog, fmt, args);
+    va_end(args);
+    fflush(timelineLog);
+}
 
-    glRotatef(e.angle, 0.0f, 1.0f, 0.0f);
-    glTranslatef(e.radius, 0.0f, 0.0f);
+// Element index by atomic number or symbol; -1 if unknown
+int findElementIndex(const char* name) {
+    int Z = atoi(name);
+    if (Z >= 1 && Z <= numElements) return Z - 1;
+    for (int i = 0; i < numElements; ++i) {
+        if (strcmp(elements[i].symbol, name) == 0) return i;
+    }
+    return -1;
+}
 
-    glutSolidSphere(1.0f, 20, 20);
-    glPopMatrix();
+// Parse one "<command> <arg>" into ev (arg may be empty); false if malformed
+bool parseTimelineEvent(const char* cmd, const char* arg, TimelineEvent& ev) {
+    ev.arg = -1;
+    if (strcmp(cmd, "element") == 0) {
+        ev.op  = TL_ELEMENT;
+        ev.arg = findElementIndex(arg);
+        return ev.arg >= 0;
+    }
+    if (strcmp(cmd, "mode") == 0) {
+        ev.op = TL_MODE;
+        if (strcmp(arg, "table") == 0) ev.arg = MODE_TABLE;
+        if (strcmp(arg, "atom") == 0)  ev.arg = MODE_ATOM;
+        return ev.arg >= 0;
+    }
+    if (strcmp(cmd, "color") == 0 || strcmp(cmd, "colour") == 0) {
+        ev.op = TL_COLOR;
+        for (int m = 0; m < NUM_COLOR_MODES; ++m) {
+            if (strcmp(arg, colorModeKeys[m]) == 0) ev.arg = m;
+        }
+        return ev.arg >= 0;
+    }
+    if (strcmp(cmd, "zoom") == 0) {
+        ev.op = TL_ZOOM;
+        if (strcmp(arg, "off") == 0) return true;
+        ev.arg = findElementIndex(arg);
+        return ev.arg >= 0;
+    }
+    if (strcmp(cmd, "ion") == 0) {
+        char* end;
+        ev.op  = TL_ION;
+        ev.arg = (int)strtol(arg, &end, 10);
+        return end != arg && *end == 0;
+    }
+    if (strcmp(cmd, "excite") == 0) {
+        ev.op  = TL_EXCITE;
+        ev.arg = arg[0] ? atoi(arg) : 1;
+        return ev.arg > 0;
+    }
+    if (strcmp(cmd, "ground") == 0) {
+        ev.op = TL_GROUND;
+        return arg[0] == 0;
+    }
+    return false;
 }
 
-void drawAtomScene() {
-    setCamera3D();
+// Read a timeline script into the fixed key/event arrays (see README).
+// Bad lines are reported and skipped; false if nothing usable was found
+bool loadTimeline(const char* path) {
+    FILE* f = fopen(path, "r");
+    if (!f) {
+        timelineMessage("[timeline] cannot open %s\n", path);
+        return false;
+    }
 
-    globalRotation += 0.02f;
-    glRotatef(globalRotation, 0.0f, 1.0f, 0.0f);
+    numCameraKeys = 0;
+    numTimelineEvents = 0;
+    timelineLength = 0.0f;
+    timelineLoop = false;
+    float loopAt = -1.0f;
+
+    char line[256];
+    int lineNo = 0;
+    while (fgets(line, sizeof(line), f)) {
+        lineNo++;
+        line[strcspn(line, "#\r\n")] = 0;   // comments, line endings
+
+        float t;
+        char cmd[32], arg[32];
+        int used = 0;
+        int fields = sscanf(line, "%f %31s %n", &t, cmd, &used);
+        if (fields == EOF) continue;          // blank line
+
+        bool ok = (fields == 2 && t >= 0.0f);
+        if (ok && strcmp(cmd, "cam") == 0) {
+            CameraKey k;
+            k.t = t;
+            ok = numCameraKeys < MAX_CAMERA_KEYS &&
+                 sscanf(line + used, "%f %f %f", &k.v[0], &k.v[1], &k.v[2]) == 3;
+            if (ok) cameraKeys[numCameraKeys++] = k;
+        } else if (ok && strcmp(cmd, "loop") == 0) {
+            loopAt = t;
+        } else if (ok) {
+            TimelineEvent ev;
+            ev.t = t;
+            arg[0] = 0;
+            sscanf(line + used, "%31s", arg);
+            ok = numTimelineEvents < MAX_TIMELINE_EVENTS && parseTimelineEvent(cmd, arg, ev);
+            if (ok) timelineEvents[numTimelineEvents++] = ev;
+        }
 
-    ElementInfo &sel = elements[selectedIndex];
+        if (!ok) {
+            timelineMessage("[timeline] %s:%d: ignored '%s'\n", path, lineNo, line);
+            continue;
+        }
+        if (t > timelineLength) timelineLength = t;
+    }
+    fclose(f);
 
-    // Draw nucleus based on this element
-    drawNucleus(sel);
+    // Scripts may list keys and events in any order; ties keep file order
+    std::stable_sort(cameraKeys, cameraKeys + numCameraKeys,
+                     [](const CameraKey& a, const CameraKey& b) { return a.t < b.t; });
+    std::stable_sort(timelineEvents, timelineEvents + numTimelineEvents,
+                     [](const TimelineEvent& a, const TimelineEvent& b) { return a.t < b.t; });
 
-    // Draw orbits & electrons
-    for (int i = 0; i < numElectrons; ++i) {
-        drawOrbit(electrons[i]);
-        drawElectron(electrons[i]);
+    if (loopAt > 0.0f) {
+        timelineLength = loopAt;
+        timelineLoop = true;
     }
 
-    // ---- 2D overlay using the SAME 'sel' ----
-    glDisable(GL_LIGHTING);
+    timelineMessage("[timeline] %s: %d camera keys, %d events, %.1f s%s\n", path,
+                    numCameraKeys, numTimelineEvents, timelineLength, timelineLoop ? ", looping" : "");
+    return numCameraKeys + numTimelineEvents > 0;
+}
 
-    glMatrixMode(GL_PROJECTION);
-    glPushMatrix();
-    glLoadIdentity();
-    gluOrtho2D(0, 100, 0, 100);
+// Start from t = 0 and apply everything scheduled there
+void rewindTimeline() {
+    timelineClock   = 0.0;
+    timelineCursor  = 0;
+    cameraCursor    = 0;
+    timelinePlaying = true;
+    advanceTimeline(0.0f);
+}
 
-    glMatrixMode(GL_MODELVIEW);
-    glPushMatrix();
-    glLoadIdentity();
+// Per timer tick: fire due events, then put the camera on the spline
+void advanceTimeline(float dt) {
+    if (!timelinePlaying) return;
 
-    char groupTxt[32];
-    if (sel.group > 0) {
-        sprintf(groupTxt, "%d", sel.group);
-    } else {
-        sprintf(groupTxt, "f-block");
+    timelineClock += dt;
+    for (;;) {
+        while (timelineCursor < numTimelineEvents &&
+               timelineEvents[timelineCursor].t <= timelineClock) {
+            applyTimelineEvent(timelineEvents[timelineCursor++]);
+        }
+        if (timelineClock < timelineLength) break;
+
+        if (!timelineLoop) {
+            timelinePlaying = false;
+            timelineClock = timelineLength;
+            timelineMessage("[timeline] finished at %.1f s\n", timelineLength);
+            break;
+        }
+        timelineClock -= timelineLength;
+        timelineCursor = 0;
+        cameraCursor   = 0;
     }
 
-    char info[256];
-    sprintf(info, "%s (%s), Z = %d, Period = %d, Group = %s",
-            sel.name, sel.symbol, sel.Z, sel.period, groupTxt);
+    if (numCameraKeys > 0) {
+        float cam[3];
+        evaluateCameraPath(timelineClock, cam);
+        camAngleX = std::min(std::max(cam[0], -89.0f), 89.0f);
+        camAngleY = cam[1];
+        camDist   = cam[2];
+    }
+}
 
-    glColor3f(0.9f, 1.0f, 0.9f);
-    drawText2D(5.0f, 95.0f, info, GLUT_BITMAP_HELVETICA_12);
+// Cubic Hermite through the keys with Catmull-Rom tangents scaled by key
+// spacing, so uneven gaps keep a smooth speed; holds the ends
+void evaluateCameraPath(double t, float* out) {
+    const int n = numCameraKeys;
+    const CameraKey* keys = cameraKeys;
 
-    glColor3f(0.8f, 0.8f, 0.8f);
-    drawText2D(5.0f, 90.0f,
-               "Arrow keys = rotate  |  +/- = zoom  |  SPACE = pause  |  'T' = Table View",
-               GLUT_BITMAP_HELVETICA_10);
+    if (n == 1 || t <= keys[0].t) {
+        memcpy(out, keys[0].v, sizeof(keys[0].v));
+        return;
+    }
+    if (t >= keys[n - 1].t) {
+        memcpy(out, keys[n - 1].v, sizeof(keys[n - 1].v));
+        return;
+    }
 
-    glPopMatrix();
-    glMatrixMode(GL_PROJECTION);
-    glPopMatrix();
-    glMatrixMode(GL_MODELVIEW);
+    // Clock only moves forward between rewinds, so the cursor does too
+    if (cameraCursor >= n - 1 || keys[cameraCursor].t > t) cameraCursor = 0;
+    while (keys[cameraCursor + 1].t <= t) cameraCursor++;
+
+    const CameraKey &k1 = keys[cameraCursor];
+    const CameraKey &k2 = keys[cameraCursor + 1];
+    const CameraKey &k0 = keys[cameraCursor > 0 ? cameraCursor - 1 : cameraCursor];
+    const CameraKey &k3 = keys[cameraCursor + 2 < n ? cameraCursor + 2 : cameraCursor + 1];
+
+    float h  = k2.t - k1.t;
+    float u  = (float)((t - k1.t) / h);
+    float u2 = u * u, u3 = u2 * u;
+    float h00 = 2.0f * u3 - 3.0f * u2 + 1.0f;
+    float h10 = u3 - 2.0f * u2 + u;
+    float h01 = -2.0f * u3 + 3.0f * u2;
+    float h11 = u3 - u2;
+
+    for (int c = 0; c < 3; ++c) {
+        float m1 = (k2.v[c] - k0.v[c]) / (k2.t - k0.t);
+        float m2 = (k3.v[c] - k1.v[c]) / (k3.t - k1.t);
+        out[c] = h00 * k1.v[c] + h10 * h * m1 + h01 * k2.v[c] + h11 * h * m2;
+    }
+}
 
-    glEnable(GL_LIGHTING);
+void applyTimelineEvent(const TimelineEvent& ev) {
+    switch (ev.op) {
+        case TL_ELEMENT:
+            // In the atom view the charge carries over and only the
+            // difference in electrons is added or removed
+            if (currentMode == MODE_ATOM) changeAtomElement(ev.arg);
+            else selectedIndex = ev.arg;
+            break;
+        case TL_MODE:
+            currentMode = (Mode)ev.arg;
+            if (currentMode == MODE_ATOM) setupElectronsFromElement(elements[selectedIndex]);
+            break;
+        case TL_COLOR:
+            if (ev.arg != colorMode) setColorMode(ev.arg);
+            break;
+        case TL_ZOOM:
+            if (ev.arg >= 0) {
+                zoomToCell(ev.arg);
+            } else {
+                tableViewTarget.cx = tableViewTarget.cy = 50.0f;
+                tableViewTarget.zoom = 1.0f;
+            }
+            break;
+        case TL_ION:
+            setIonCharge(ev.arg);
+            if (ev.arg < 0 && ionCharge != ev.arg)
+                timelineMessage("[timeline] %s holds at most %d extra electron(s); charge is %d\n",
+                                elements[selectedIndex].symbol,
+                                maxAnionCharge(elements[selectedIndex].Z), ionCharge);
+            break;
+        case TL_EXCITE:
+            for (int n = 0; n < ev.arg && exciteElectron(); ++n) {}
+            break;
+        case TL_GROUND:
+            relaxElectrons();
+            break;
+    }
 }
 
+// Kiosks ignore input; normal playback hands control back to the user
+bool timelineBlocksInput() {
+    if (kioskMode) return true;
+    if (timelinePlaying) {
+        timelinePlaying = false;
+        timelineMessage("[timeline] stopped by user input\n");
+    }
+    return false;
+}
 
 // --------------------------------------------------------
 // GLUT callbacks
 // --------------------------------------------------------
 void display() {
+    double frameStart = nowMs();
+
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
     int w = glutGet(GLUT_WINDOW_WIDTH);
@@ -696,7 +3716,20 @@ void display() {
         drawAtomScene();
     }
 
+    // Wait for the GPU so the governor sees render cost, not vsync wait
+    glFinish();
+    updateQualityGovernor((float)(nowMs() - frameStart));
+
+    if (streamEnabled) captureStreamFrame(w, h);
+
     glutSwapBuffers();
+
+    if (!firstFrameDone) {
+        firstFrameDone = true;
+        printf("[startup] time-to-first-frame %.1f ms (scene cache: %s)\n",
+               nowMs() - appStartMs, sceneCacheStatus);
+        fflush(stdout);
+    }
 }
 
 void reshape(int w, int h) {
@@ -707,34 +3740,78 @@ void reshape(int w, int h) {
 
 // Timer callback – animate electrons
 void timer(int value) {
+    int intervalMs = animationTimerMs();
+
+    // Scripts run on the animation clock, like the electrons
+    if (timelinePlaying) advanceTimeline(intervalMs / 1000.0f);
+
     if (!isPaused && currentMode == MODE_ATOM) {
-        for (int i = 0; i < numElectrons; ++i) {
-            electrons[i].angle += electrons[i].speed;
-            if (electrons[i].angle > 360.0f)
-                electrons[i].angle -= 360.0f;
-        }
+        // speeds are tuned per 16 ms tick; keep angular velocity when ticks get longer
+        advanceOrbits(intervalMs / 16.0f);
+        updateElectronShells(intervalMs / 1000.0f);
+    }
+    if (currentMode == MODE_TABLE) {
+        updateTableView(intervalMs / 1000.0f);
     }
     glutPostRedisplay();
-    glutTimerFunc(16, timer, 0);  // ~60 FPS
+    glutTimerFunc(intervalMs, timer, 0);  // ~60 FPS at full quality
 }
 
 void keyboard(unsigned char key, int x, int y) {
+    if (key == 27) std::exit(0);   // ESC works even in kiosk mode
+    if (timelineBlocksInput()) return;
+
     switch (key) {
-        case 27: // ESC
-            std::exit(0);
-            break;
         case ' ':
             isPaused = !isPaused;
             break;
         case '+':
         case '=':
+            if (currentMode == MODE_TABLE) {
+                zoomTableAt(tableViewTarget.cx, tableViewTarget.cy, 1.5f);
+                break;
+            }
             camDist -= 1.0f;
             if (camDist < 10.0f) camDist = 10.0f;
             break;
         case '-':
+            if (currentMode == MODE_TABLE) {
+                zoomTableAt(tableViewTarget.cx, tableViewTarget.cy, 1.0f / 1.5f);
+                break;
+            }
             camDist += 1.0f;
             if (camDist > 120.0f) camDist = 120.0f;
             break;
+        case 'z':
+        case 'Z':
+            if (currentMode == MODE_TABLE) zoomToCell(selectedIndex);
+            break;
+        case '0':
+            if (currentMode == MODE_TABLE) {
+                tableViewTarget.cx = tableViewTarget.cy = 50.0f;
+                tableViewTarget.zoom = 1.0f;
+            }
+            break;
+        case 'c':
+        case 'C':
+            if (currentMode == MODE_TABLE) setColorMode(colorMode + 1);
+            break;
+        case ',':
+            if (currentMode == MODE_ATOM) ionizeElectron();
+            break;
+        case '.':
+            if (currentMode == MODE_ATOM && !captureElectron())
+                printf("[ion] %s holds at most %d extra electron(s)\n",
+                       elements[selectedIndex].symbol, maxAnionCharge(elements[selectedIndex].Z));
+            break;
+        case 'e':
+        case 'E':
+            if (currentMode == MODE_ATOM) exciteElectron();
+            break;
+        case 'g':
+        case 'G':
+            if (currentMode == MODE_ATOM) relaxElectrons();
+            break;
         case 't':
         case 'T':
             currentMode = MODE_TABLE;
@@ -744,12 +3821,28 @@ void keyboard(unsigned char key, int x, int y) {
             currentMode = MODE_ATOM;
             setupElectronsFromElement(elements[selectedIndex]);
             break;
+        case 'q':
+        case 'Q':
+            governorEnabled = !governorEnabled;
+            printf("[quality] governor %s\n", governorEnabled ? "auto" : "manual");
+            fflush(stdout);
+            break;
+        case '[':
+            governorEnabled = false;
+            setQualityLevel(qualityIndex - 1, "manual");
+            break;
+        case ']':
+            governorEnabled = false;
+            setQualityLevel(qualityIndex + 1, "manual");
+            break;
     }
 
     glutPostRedisplay();
 }
 
 void specialKeys(int key, int x, int y) {
+    if (timelineBlocksInput()) return;
+
     if (currentMode == MODE_TABLE) {
         // Change selected element by index
         if (key == GLUT_KEY_LEFT) {
@@ -760,6 +3853,14 @@ void specialKeys(int key, int x, int y) {
             selectedIndex++;
             if (selectedIndex >= numElements) selectedIndex = 0;
         }
+
+        // Zoomed in: keep the selection in view
+        if (tableViewTarget.zoom > 1.0f) {
+            float zoom = tableViewTarget.zoom;
+            zoomToCell(selectedIndex);
+            tableViewTarget.zoom = zoom;
+            clampTableView(tableViewTarget);
+        }
     } else {
         // Atom view: rotate camera
         switch (key) {
@@ -784,44 +3885,485 @@ void specialKeys(int key, int x, int y) {
 
 // Mouse click to select element on table
 void mouse(int button, int state, int x, int y) {
+    // Checked first so a click in the atom view also takes over from --play
+    if (state == GLUT_DOWN && timelineBlocksInput()) return;
     if (currentMode != MODE_TABLE) return;
+
+    // Convert window coords -> table space through the zoom view
+    float fx, fy;
+    windowToTable(x, y, fx, fy);
+
+    // GLUT reports the wheel as buttons 3 (up) and 4 (down)
+    if ((button == 3 || button == 4) && state == GLUT_DOWN) {
+        zoomTableAt(fx, fy, button == 3 ? 1.25f : 1.0f / 1.25f);
+        return;
+    }
+    if (button == GLUT_RIGHT_BUTTON) {
+        tablePanning = (state == GLUT_DOWN);
+        panLastX = x;
+        panLastY = y;
+        return;
+    }
     if (button != GLUT_LEFT_BUTTON || state != GLUT_DOWN) return;
 
+    int hit = hitTestTable(fx, fy);
+    if (hit >= 0) selectedIndex = hit;
+
+    glutPostRedisplay();
+}
+
+// Cursor position steers which thumbnails are rendered first
+void passiveMotion(int x, int y) {
+    if (currentMode != MODE_TABLE) return;
+
+    float fx, fy;
+    windowToTable(x, y, fx, fy);
+    setThumbnailFocus(fx, fy);
+}
+
+// Right-drag pans the zoomed table; moves view and target together
+void motion(int x, int y) {
+    if (currentMode != MODE_TABLE || !tablePanning || kioskMode) return;
+
     int width  = glutGet(GLUT_WINDOW_WIDTH);
     int height = glutGet(GLUT_WINDOW_HEIGHT);
+    if (width == 0 || height == 0) return;
+
+    float left, bottom, vw, vh;
+    tableViewRect(tableView, left, bottom, vw, vh);
+    float dx = (x - panLastX) * vw / width;
+    float dy = (y - panLastY) * vh / height;
+    panLastX = x;
+    panLastY = y;
+
+    tableViewTarget.cx -= dx;
+    tableViewTarget.cy += dy;
+    clampTableView(tableViewTarget);
+    tableView.cx = tableViewTarget.cx;
+    tableView.cy = tableViewTarget.cy;
+    glutPostRedisplay();
+}
+
+// --------------------------------------------------------
+// Microbenchmarks (--bench): kernels only, no window / GL
+// --------------------------------------------------------
+struct BenchResult {
+    char   name[64];
+    char   param[32];
+    long   opsPerSample;
+    int    samples;
+    double nsMin;
+    double nsMedian;
+    double nsMean;
+};
 
-    // Convert window coords -> [0,100] space
-    float fx = (float)x * 100.0f / width;
-    float fy = (float)(height - y) * 100.0f / height;
+const int MAX_BENCH_RESULTS = 32;
+const int BENCH_SAMPLES     = 15;
+BenchResult benchResults[MAX_BENCH_RESULTS];
+int numBenchResults = 0;
 
-    for (int i = 0; i < cellCount; ++i) {
-        CellRect &c = cellRects[i];
-        if (fx >= c.x && fx <= c.x + c.w &&
-            fy >= c.y && fy <= c.y + c.h) {
-            selectedIndex = c.elementIndex;
-            break;
+volatile long benchSink = 0;   // keeps results observable to the optimizer
+long benchPoints = 0;
+
+void benchCountPixel(float x, float y) {
+    benchPoints++;
+}
+
+// Time 'body' BENCH_SAMPLES times (after one warm-up) and record ns per op
+void benchRecord(const char* name, const char* param, long opsPerSample,
+                 void (*body)(long)) {
+    double samples[BENCH_SAMPLES];
+
+    body(opsPerSample);  // warm-up
+    for (int s = 0; s < BENCH_SAMPLES; ++s) {
+        double t0 = nowMs();
+        body(opsPerSample);
+        samples[s] = (nowMs() - t0) * 1.0e6 / (double)opsPerSample;
+    }
+    std::sort(samples, samples + BENCH_SAMPLES);
+
+    double sum = 0.0;
+    for (int s = 0; s < BENCH_SAMPLES; ++s) sum += samples[s];
+
+    if (numBenchResults >= MAX_BENCH_RESULTS) return;
+    BenchResult &r = benchResults[numBenchResults++];
+    snprintf(r.name,  sizeof(r.name),  "%s", name);
+    snprintf(r.param, sizeof(r.param), "%s", param);
+    r.opsPerSample = opsPerSample;
+    r.samples  = BENCH_SAMPLES;
+    r.nsMin    = samples[0];
+    r.nsMedian = samples[BENCH_SAMPLES / 2];
+    r.nsMean   = sum / BENCH_SAMPLES;
+
+    fprintf(stderr, "  %-28s %-14s %12.1f ns/op (min %.1f)\n",
+            r.name, r.param, r.nsMedian, r.nsMin);
+}
+
+// One op = electron shells for all 118 elements, from the scene cache when
+// one is bound
+void benchSetupElectrons(long ops) {
+    for (long n = 0; n < ops; ++n) {
+        for (int i = 0; i < numElements; ++i) {
+            setupElectronsFromElement(elements[i]);
+            benchSink += numElectrons;
         }
     }
+}
 
-    glutPostRedisplay();
+// One op = nucleus layouts for all 118 elements at the "High" nucleon cap,
+// from the scene cache when one is bound
+void benchPrepareNucleus(long ops) {
+    int cap = qualityLevels[3].maxNucleonsDraw;
+    for (long n = 0; n < ops; ++n) {
+        for (int i = 0; i < numElements; ++i) {
+            benchSink += prepareNucleus(elements[i], cap);
+        }
+    }
+}
+
+Electron* benchElectrons = 0;
+int benchElectronCount = 0;
+
+// One op = one timer tick over benchElectronCount electrons
+void benchUpdateElectrons(long ops) {
+    for (long n = 0; n < ops; ++n) {
+        updateElectrons(benchElectrons, benchElectronCount, 1.0f);
+    }
+    benchSink += (long)benchElectrons[0].angle;
+}
+
+// One op = a fan of 64 lines (all octants) across the 0..100 space
+void benchLineDDA(long ops) {
+    for (long n = 0; n < ops; ++n) {
+        for (int k = 0; k < 64; ++k) {
+            float ang = 2.0f * PI * k / 64.0f;
+            rasterLineDDA(50.0f, 50.0f,
+                          50.0f + 45.0f * cosf(ang), 50.0f + 45.0f * sinf(ang),
+                          benchCountPixel);
+        }
+    }
+    benchSink += benchPoints;
+}
+
+// One op = 10,000 clicks on a 100x100 grid over the table
+void benchHitTest(long ops) {
+    for (long n = 0; n < ops; ++n) {
+        for (int gy = 0; gy < 100; ++gy) {
+            for (int gx = 0; gx < 100; ++gx) {
+                benchSink += hitTestTable(gx + 0.5f, gy + 0.5f);
+            }
+        }
+    }
+}
+
+// One op = an ionisation sweep over all 118 elements: step to the next
+// element, strip it to the bare nucleus one electron at a time, then
+// recapture them all, rebalancing after each step like a frame would
+void benchIonSweepIncremental(long ops) {
+    for (long n = 0; n < ops; ++n) {
+        setupElectronsFromElement(elements[0]);
+        for (int i = 0; i < numElements; ++i) {
+            if (i > 0) changeAtomElement(i);
+            updateElectronShells(0.0f);
+            for (int k = 0; k < elements[i].Z; ++k) {
+                ionizeElectron();
+                updateElectronShells(0.0f);
+            }
+            for (int k = 0; k < elements[i].Z; ++k) {
+                captureElectron();
+                updateElectronShells(0.0f);
+            }
+            numEscaping = 0;
+        }
+        benchSink += numElectrons;
+    }
+    selectedIndex = 0;
+    setupElectronsFromElement(elements[0]);
+}
+
+// Full rebuild of electrons and shell state for 'count' electrons around Z
+void benchRebuildShells(int Z, int count) {
+    numElectrons = fillGroundShells(count, electrons);
+    resetShellState(numElectrons);
+    ionCharge = Z - numElectrons;
+}
+
+// Same electron counts as above, rebuilding every shell at each step
+void benchIonSweepRebuild(long ops) {
+    for (long n = 0; n < ops; ++n) {
+        for (int i = 0; i < numElements; ++i) {
+            int Z = elements[i].Z;
+            selectedIndex = i;
+            benchRebuildShells(Z, Z);
+            for (int k = Z - 1; k >= 0; --k) benchRebuildShells(Z, k);
+            for (int k = 1; k <= Z; ++k)     benchRebuildShells(Z, k);
+        }
+        benchSink += numElectrons;
+    }
+    selectedIndex = 0;
+    setupElectronsFromElement(elements[0]);
+}
+
+std::vector<unsigned char> benchSceneImage;
+
+// One op = building the whole scene cache image from scratch (cold start)
+void benchSceneBuild(long ops) {
+    for (long n = 0; n < ops; ++n) {
+        buildSceneImage(benchSceneImage);
+        benchSink += (long)benchSceneImage.size();
+    }
+}
+
+// One op = checksum + bind of an existing image (warm start, minus the mmap)
+void benchSceneBind(long ops) {
+    for (long n = 0; n < ops; ++n) {
+        benchSink += bindSceneImage(benchSceneImage.data(), benchSceneImage.size());
+    }
+}
+
+// Scenario runs use a fixed tick and window size so every machine
+// simulates exactly the same frames
+const float SCENARIO_STEP = 0.016f;
+const int   SCENARIO_WIDTH = 1100, SCENARIO_HEIGHT = 720;
+unsigned int scenarioChecksum = 0;
+
+// Start-up state of the app, restored before every scenario pass
+void resetScenarioState() {
+    currentMode   = MODE_TABLE;
+    selectedIndex = 0;
+    isPaused      = false;
+    camAngleY = 30.0f;
+    camAngleX = 20.0f;
+    camDist   = 35.0f;
+    tableView.cx = tableView.cy = 50.0f;
+    tableView.zoom = 1.0f;
+    tableViewTarget = tableView;
+    colorMode  = COLOR_CATEGORY;
+    colorBlend = 1.0f;
+    setupElectronsFromElement(elements[selectedIndex]);
+    scenarioChecksum = 2166136261u;
+}
+
+// One simulated frame: timeline, animation and the CPU side of drawing
+void scenarioFrame() {
+    advanceTimeline(SCENARIO_STEP);
+
+    if (currentMode == MODE_ATOM) {
+        if (!isPaused) {
+            advanceOrbits(SCENARIO_STEP * 1000.0f / 16.0f);
+            updateElectronShells(SCENARIO_STEP);
+        }
+        float eye[3];
+        cameraEye(eye);
+        int count = prepareNucleus(elements[selectedIndex], qualityLevels[qualityIndex].maxNucleonsDraw);
+
+        scenarioChecksum = fnv1a(eye, sizeof(eye), scenarioChecksum);
+        scenarioChecksum = fnv1a(&count, sizeof(count), scenarioChecksum);
+        for (int s = 0; s < NUM_SHELLS; ++s) {
+            scenarioChecksum = fnv1a(electrons + shellFirst[s], shellCount[s] * sizeof(Electron),
+                                     scenarioChecksum);
+        }
+    } else {
+        updateTableView(SCENARIO_STEP);
+        static int   visible[200];
+        static float rects[200 * 4];
+        int lod;
+        int count = cullTableCells(SCENARIO_WIDTH, SCENARIO_HEIGHT, visible, rects, lod);
+
+        scenarioChecksum = fnv1a(&lod, sizeof(lod), scenarioChecksum);
+        scenarioChecksum = fnv1a(rects, count * 4 * sizeof(float), scenarioChecksum);
+    }
+    scenarioChecksum = fnv1a(&selectedIndex, sizeof(selectedIndex), scenarioChecksum);
+}
+
+// One op = one frame; each sample replays the loaded script from t = 0
+void benchScenario(long ops) {
+    resetScenarioState();
+    rewindTimeline();
+    for (long n = 0; n < ops; ++n) {
+        scenarioFrame();
+    }
+    benchSink += (long)scenarioChecksum;
+}
+
+// Run every kernel benchmark; JSON goes to outPath (or stdout)
+int runBenchmarks(const char* outPath, const char** scenarios, int numScenarios) {
+    // Open the output first so an unwritable path fails before the long run
+    FILE* out = stdout;
+    if (outPath) {
+        out = fopen(outPath, "w");
+        if (!out) {
+            fprintf(stderr, "Cannot write benchmark results to %s: %s\n", outPath, strerror(errno));
+            return 1;
+        }
+    }
+
+    fprintf(stderr, "Running kernel benchmarks (%d samples each)...\n", BENCH_SAMPLES);
+
+    layoutPeriodicTable();
+
+    // Generated path first, with nothing bound, as with --no-scene-cache;
+    // the cached path is measured once sceneCache.bind has bound an image
+    unbindSceneImage();
+    benchRecord("setupElectronsFromElement", "Z=1..118 generated", 200, benchSetupElectrons);
+    benchRecord("prepareNucleus", "Z=1..118 generated", 50, benchPrepareNucleus);
+
+    const int counts[] = { 100, 1000, 10000, 100000, 1000000 };
+    for (int c = 0; c < 5; ++c) {
+        benchElectronCount = counts[c];
+        benchElectrons = new Electron[benchElectronCount];
+
+        // Replicate the Og (Z=118) shell pattern across the whole array
+        setupElectronsFromElement(elements[numElements - 1]);
+        for (int i = 0; i < benchElectronCount; ++i) {
+            benchElectrons[i] = electrons[i % numElectrons];
+        }
+
+        char param[32];
+        sprintf(param, "n=%d", benchElectronCount);
+        benchRecord("timer.updateElectrons", param, 10000000L / benchElectronCount + 1,
+                    benchUpdateElectrons);
+
+        delete[] benchElectrons;
+        benchElectrons = 0;
+    }
+
+    benchRecord("ionSweep.incremental", "Z=1..118", 20, benchIonSweepIncremental);
+    benchRecord("ionSweep.rebuild", "Z=1..118", 20, benchIonSweepRebuild);
+
+    benchRecord("rasterLineDDA", "64 lines", 200, benchLineDDA);
+    benchRecord("hitTestTable", "100x100 grid", 20, benchHitTest);
+
+    benchRecord("sceneCache.build", "full image", 5, benchSceneBuild);
+    benchRecord("sceneCache.bind", "full image", 20, benchSceneBind);
+
+    // benchSceneImage stays bound from here on, like a normal start
+    benchRecord("setupElectronsFromElement", "Z=1..118 cached", 200, benchSetupElectrons);
+    benchRecord("prepareNucleus", "Z=1..118 cached", 50, benchPrepareNucleus);
+
+    // Timeline scripts (--scenario) as deterministic end-to-end frame loops,
+    // on the cached path
+    buildPropertyColors();
+    for (int s = 0; s < numScenarios; ++s) {
+        timelineLog = stderr;
+        if (!loadTimeline(scenarios[s])) continue;
+        timelineLog = 0;
+
+        long frames = (long)ceilf(timelineLength / SCENARIO_STEP) + 1;
+        const char* name = strrchr(scenarios[s], '/');
+        if (!name) name = strrchr(scenarios[s], '\\');
+        name = name ? name + 1 : scenarios[s];
+
+        char param[32];
+        snprintf(param, sizeof(param), "%s cached", name);
+        benchRecord("scenario", param, frames, benchScenario);
+        fprintf(stderr, "  [scenario] %s: %ld frames, state checksum %08x\n",
+                name, frames, scenarioChecksum);
+    }
+
+    fprintf(out, "{\n  \"suite\": \"atom-kernels\",\n  \"format\": 1,\n  \"results\": [\n");
+    for (int i = 0; i < numBenchResults; ++i) {
+        const BenchResult &r = benchResults[i];
+        fprintf(out, "    { \"name\": \"%s\", \"param\": \"%s\", \"ops_per_sample\": %ld, "
+                     "\"samples\": %d, \"ns_per_op_min\": %.1f, \"ns_per_op_median\": %.1f, "
+                     "\"ns_per_op_mean\": %.1f }%s\n",
+                r.name, r.param, r.opsPerSample, r.samples,
+                r.nsMin, r.nsMedian, r.nsMean,
+                (i + 1 < numBenchResults) ? "," : "");
+    }
+    fprintf(out, "  ]\n}\n");
+
+    if (out != stdout) {
+        fclose(out);
+        fprintf(stderr, "Results written to %s\n", outPath);
+    }
+    return 0;
 }
 
 // --------------------------------------------------------
 // Main
 // --------------------------------------------------------
 int main(int argc, char** argv) {
+    appStartMs = nowMs();
+
+    // Benchmarks run before glutInit so they need no display
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--bench") == 0) {
+            const char* outPath = 0;
+            const char* scenarios[16];
+            int numScenarios = 0;
+            for (int j = 1; j + 1 < argc; ++j) {
+                if (strcmp(argv[j], "--bench-out") == 0) outPath = argv[j + 1];
+                if (strcmp(argv[j], "--scenario") == 0 && numScenarios < 16) scenarios[numScenarios++] = argv[j + 1];
+            }
+            return runBenchmarks(outPath, scenarios, numScenarios);
+        }
+    }
+
     glutInit(&argc, argv);
+
+    // Remaining args (GLUT removes its own):
+    //   --budget <ms>  --stream [port]  --stream-fps <n>  --stream-public  --no-scene-cache
+    //   --play <script>  --kiosk <script>
+    int streamRequestPort = 0;
+    const char* timelinePath = 0;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--budget") == 0 && i + 1 < argc) {
+            float ms = (float)atof(argv[++i]);
+            if (ms > 1.0f) frameBudgetMs = ms;
+        }
+        else if (strcmp(argv[i], "--stream") == 0) {
+            streamRequestPort = streamPort;
+            if (i + 1 < argc && atoi(argv[i + 1]) > 0) streamRequestPort = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--stream-public") == 0) {
+            streamPublic = true;
+        }
+        else if (strcmp(argv[i], "--stream-fps") == 0 && i + 1 < argc) {
+            int fps = atoi(argv[++i]);
+            if (fps > 0) streamFps = fps;
+        }
+        else if (strcmp(argv[i], "--no-scene-cache") == 0) {
+            useSceneCache = false;
+        }
+        else if ((strcmp(argv[i], "--play") == 0 || strcmp(argv[i], "--kiosk") == 0) && i + 1 < argc) {
+            kioskMode = (strcmp(argv[i], "--kiosk") == 0);
+            timelinePath = argv[++i];
+        }
+    }
+    // An unattended kiosk with a broken script should not sit on a static table
+    if (timelinePath && !loadTimeline(timelinePath)) {
+        if (kioskMode) return 1;
+        timelinePath = 0;
+    }
+
+    printf("[quality] start at %s, frame budget %.1f ms\n",
+           qualityLevels[qualityIndex].name, frameBudgetMs);
+    fflush(stdout);
+
     glutInitDisplayMode(GLUT_DOUBLE | GLUT_RGB | GLUT_DEPTH);
     glutInitWindowSize(1100, 720);
     glutCreateWindow("Interactive 3D Atom + Full Periodic Table (Lanthanides & Actinides Separate)");
 
     init();
+    if (streamRequestPort > 0) startFrameStreaming(streamRequestPort);
+
+    if (timelinePath) {
+        if (kioskMode) {
+            timelineLoop = timelineLength > 0.0f;
+            glutFullScreen();
+            glutSetCursor(GLUT_CURSOR_NONE);
+        }
+        rewindTimeline();
+    }
 
     glutDisplayFunc(display);
     glutReshapeFunc(reshape);
     glutKeyboardFunc(keyboard);
     glutSpecialFunc(specialKeys);
     glutMouseFunc(mouse);
+    glutPassiveMotionFunc(passiveMotion);
+    glutMotionFunc(motion);
     glutTimerFunc(0, timer, 0);
 
     glutMainLoop();